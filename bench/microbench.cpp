@@ -0,0 +1,533 @@
+// Microbenchmark suite for regression checks (make bench).
+//
+// Every case (trie / operation / dataset size) is timed several times and
+// all samples are kept, so a run can be saved as a baseline and a later
+// run compared against it with a rank-sum test instead of eyeballing two
+// averages. Datasets come from a fixed seed, so every run measures the
+// same keys.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "standard_trie.h"
+#include "compressed_trie.h"
+#include "double_array_trie.h"
+
+#ifdef __unix__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+struct Options {
+    std::vector<std::string> tries = {"standard", "compressed", "double_array"};
+    std::vector<size_t> sizes = {1000, 10000, 100000};
+    size_t queries = 10000;
+    int repeats = 10;
+    std::string saveFile;
+    std::string compareFile;
+    double alpha = 0.01;      // significance level for the one-sided test
+    double threshold = 0.10;  // smallest slowdown worth failing on
+    int confirmRuns = 2;      // reruns of a trie/size whose cases look slower
+};
+
+// All samples of one case, in nanoseconds per operation
+struct CaseResult {
+    std::string name;  // e.g. "compressed/search_hit/10000"
+    std::vector<double> samples;
+
+    double median() const {
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        size_t n = sorted.size();
+        if (n == 0) return 0.0;
+        return n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    }
+};
+
+struct Workload {
+    std::vector<std::string> keys;
+    std::vector<std::string> hits;
+    std::vector<std::string> misses;
+    std::vector<std::string> prefixes;
+};
+
+static Workload makeWorkload(size_t size, size_t queries) {
+    std::mt19937 rng(12345 + static_cast<unsigned>(size));
+    std::uniform_int_distribution<> lenDist(5, 15);
+    std::uniform_int_distribution<> charDist('a', 'z');
+
+    auto randomKey = [&]() {
+        std::string key(lenDist(rng), ' ');
+        for (char& c : key) {
+            c = static_cast<char>(charDist(rng));
+        }
+        return key;
+    };
+
+    Workload w;
+    std::unordered_set<std::string> seen;
+    while (w.keys.size() < size) {
+        std::string key = randomKey();
+        if (seen.insert(key).second) {
+            w.keys.push_back(key);
+        }
+    }
+
+    std::uniform_int_distribution<size_t> pick(0, size - 1);
+    while (w.hits.size() < queries) {
+        const std::string& key = w.keys[pick(rng)];
+        w.hits.push_back(key);
+        w.prefixes.push_back(key.substr(0, key.size() / 2 + 1));
+    }
+    while (w.misses.size() < queries) {
+        std::string key = randomKey();
+        if (!seen.count(key)) {
+            w.misses.push_back(key);
+        }
+    }
+
+    return w;
+}
+
+using Clock = std::chrono::steady_clock;
+
+static double nanosSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+static constexpr int QUERY_PASSES = 3;
+
+// Anything the timed loops compute goes here so it can't be optimized away
+static volatile size_t sink = 0;
+
+template<typename TrieType>
+static std::vector<CaseResult> runTrie(const std::string& name, const Workload& w, int repeats) {
+    std::string suffix = "/" + std::to_string(w.keys.size());
+    CaseResult insert{name + "/insert" + suffix, {}};
+    CaseResult hit{name + "/search_hit" + suffix, {}};
+    CaseResult miss{name + "/search_miss" + suffix, {}};
+    CaseResult prefix{name + "/prefix" + suffix, {}};
+    CaseResult enumerate{name + "/enumerate" + suffix, {}};
+
+    for (int r = 0; r < repeats; r++) {
+        TrieType trie;
+        auto start = Clock::now();
+        for (const auto& key : w.keys) {
+            trie.insert(key);
+        }
+        insert.samples.push_back(nanosSince(start) / w.keys.size());
+
+        // Queries are cheap to repeat, so each sample is the best of a few
+        // passes, which filters out most scheduler noise
+        auto timeQueries = [&](const std::vector<std::string>& queries, bool prefixes, CaseResult& out) {
+            double best = 0;
+            for (int pass = 0; pass < QUERY_PASSES; pass++) {
+                auto begin = Clock::now();
+                for (const auto& query : queries) {
+                    sink += prefixes ? trie.startsWith(query) : trie.search(query);
+                }
+                double elapsed = nanosSince(begin);
+                best = pass == 0 ? elapsed : std::min(best, elapsed);
+            }
+            out.samples.push_back(best / queries.size());
+        };
+        timeQueries(w.hits, false, hit);
+        timeQueries(w.misses, false, miss);
+        timeQueries(w.prefixes, true, prefix);
+
+        start = Clock::now();
+        trie.rangeScan("", "", [](const std::string& key) {
+            sink += key.size();
+            return true;
+        });
+        enumerate.samples.push_back(nanosSince(start) / w.keys.size());
+    }
+
+    return {insert, hit, miss, prefix, enumerate};
+}
+
+using SuiteEntry = std::function<std::vector<CaseResult>(const Workload&, int)>;
+
+static const std::map<std::string, SuiteEntry>& suite() {
+    static const std::map<std::string, SuiteEntry> entries = {
+        {"standard", [](const Workload& w, int n) { return runTrie<StandardTrie>("standard", w, n); }},
+        {"compressed", [](const Workload& w, int n) { return runTrie<CompressedTrie>("compressed", w, n); }},
+        {"double_array", [](const Workload& w, int n) { return runTrie<DoubleArrayTrie>("double_array", w, n); }},
+        {"standard_az", [](const Workload& w, int n) {
+            return runTrie<BasicStandardTrie<LowercaseAlphabet>>("standard_az", w, n);
+        }},
+        {"compressed_az", [](const Workload& w, int n) {
+            return runTrie<BasicCompressedTrie<LowercaseAlphabet>>("compressed_az", w, n);
+        }},
+        {"double_array_az", [](const Workload& w, int n) {
+            return runTrie<BasicDoubleArrayTrie<LowercaseAlphabet>>("double_array_az", w, n);
+        }},
+    };
+    return entries;
+}
+
+// One case per line: {"case":"...","unit":"ns/op","median":...,"samples":[...]}
+static void writeResults(std::ostream& out, const std::vector<CaseResult>& results) {
+    out << std::setprecision(6);
+    for (const auto& result : results) {
+        out << "{\"case\":\"" << result.name << "\",\"unit\":\"ns/op\",\"median\":" << result.median()
+            << ",\"samples\":[";
+        for (size_t i = 0; i < result.samples.size(); i++) {
+            out << (i ? "," : "") << result.samples[i];
+        }
+        out << "]}\n";
+    }
+}
+
+// Reads the format written by writeResults (not a general JSON parser)
+static std::vector<CaseResult> readResults(std::istream& in) {
+    std::vector<CaseResult> results;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t nameStart = line.find("\"case\":\"");
+        size_t samplesStart = line.find("\"samples\":[");
+        if (nameStart == std::string::npos || samplesStart == std::string::npos) {
+            continue;
+        }
+        nameStart += 8;
+
+        CaseResult result;
+        result.name = line.substr(nameStart, line.find('"', nameStart) - nameStart);
+
+        samplesStart += 11;
+        std::stringstream samples(line.substr(samplesStart, line.find(']', samplesStart) - samplesStart));
+        std::string item;
+        while (std::getline(samples, item, ',')) {
+            result.samples.push_back(std::stod(item));
+        }
+        results.push_back(result);
+    }
+    return results;
+}
+
+// Runs one trie/size group in a forked child. Allocator state left over
+// from earlier groups otherwise changes node placement, and with it
+// search times by up to 2x, depending on what ran before.
+static std::vector<CaseResult> runIsolated(const std::string& trie, const Workload& w, int repeats) {
+#ifdef __unix__
+    int fds[2];
+    if (pipe(fds) == 0) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            std::ostringstream out;
+            writeResults(out, suite().at(trie)(w, repeats));
+            std::string text = out.str();
+            for (size_t done = 0; done < text.size();) {
+                ssize_t n = write(fds[1], text.data() + done, text.size() - done);
+                if (n <= 0) _exit(1);
+                done += n;
+            }
+            _exit(0);
+        }
+
+        close(fds[1]);
+        std::string text;
+        char buffer[4096];
+        ssize_t n;
+        while (pid > 0 && (n = read(fds[0], buffer, sizeof(buffer))) > 0) {
+            text.append(buffer, n);
+        }
+        close(fds[0]);
+
+        int status = 0;
+        if (pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+            std::istringstream in(text);
+            return readResults(in);
+        }
+        std::cerr << "Child for " << trie << " failed, running in-process\n";
+    }
+#endif
+    return suite().at(trie)(w, repeats);
+}
+
+// One-sided Mann-Whitney U test: probability of seeing current samples
+// this much larger than baseline if both came from the same distribution.
+// Uses the normal approximation with a tie correction.
+static double slowerPValue(const std::vector<double>& baseline, const std::vector<double>& current) {
+    size_t n1 = baseline.size();
+    size_t n2 = current.size();
+    if (n1 == 0 || n2 == 0) return 1.0;
+
+    std::vector<std::pair<double, int>> all;
+    for (double v : baseline) all.push_back({v, 0});
+    for (double v : current) all.push_back({v, 1});
+    std::sort(all.begin(), all.end());
+
+    double rankSum = 0;   // ranks of the current samples
+    double tieTerm = 0;   // sum of t^3 - t over tie groups
+    for (size_t i = 0; i < all.size();) {
+        size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) j++;
+        double rank = (i + 1 + j) / 2.0;  // average of ranks i+1..j
+        for (size_t k = i; k < j; k++) {
+            if (all[k].second == 1) rankSum += rank;
+        }
+        double t = static_cast<double>(j - i);
+        tieTerm += t * t * t - t;
+        i = j;
+    }
+
+    double n = static_cast<double>(n1 + n2);
+    double u = rankSum - n2 * (n2 + 1) / 2.0;
+    double mean = n1 * n2 / 2.0;
+    double variance = n1 * n2 / 12.0 * ((n + 1) - tieTerm / (n * (n - 1)));
+    if (variance <= 0) return 1.0;
+
+    double z = (u - mean) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+struct Verdict {
+    double change = 0;  // relative change of the median
+    double p = 1;       // p-value of the direction it moved in
+    const char* label = "same";
+    bool regression = false;
+};
+
+static Verdict judge(const CaseResult& before, const CaseResult& after, const Options& opts) {
+    Verdict v;
+    double base = before.median();
+    v.change = base > 0 ? after.median() / base - 1.0 : 0.0;
+
+    double pSlower = slowerPValue(before.samples, after.samples);
+    double pFaster = slowerPValue(after.samples, before.samples);
+    v.p = std::min(pSlower, pFaster);
+
+    if (pSlower < opts.alpha && v.change > opts.threshold) {
+        v.label = "REGRESSION";
+        v.regression = true;
+    } else if (pFaster < opts.alpha && v.change < -opts.threshold) {
+        v.label = "faster";
+    }
+    return v;
+}
+
+// Prints one line per case and returns the number of regressions
+static int compareResults(const std::map<std::string, CaseResult>& baseline,
+                          const std::vector<CaseResult>& current, const Options& opts) {
+    int regressions = 0;
+
+    std::cout << std::left << std::setw(36) << "Case" << std::right
+              << std::setw(12) << "Base ns" << std::setw(12) << "Now ns"
+              << std::setw(10) << "Change" << std::setw(10) << "p" << "  Verdict\n";
+
+    for (const auto& result : current) {
+        std::cout << std::left << std::setw(36) << result.name << std::right << std::fixed;
+
+        auto it = baseline.find(result.name);
+        if (it == baseline.end()) {
+            std::cout << std::setw(12) << "-" << std::setw(12) << std::setprecision(1) << result.median()
+                      << std::setw(10) << "-" << std::setw(10) << "-" << "  new\n";
+            continue;
+        }
+
+        Verdict v = judge(it->second, result, opts);
+        if (v.regression) {
+            regressions++;
+        }
+
+        std::cout << std::setw(12) << std::setprecision(1) << it->second.median()
+                  << std::setw(12) << result.median()
+                  << std::setw(9) << std::showpos << v.change * 100 << "%" << std::noshowpos
+                  << std::setw(10) << std::setprecision(4) << v.p
+                  << "  " << v.label << "\n";
+    }
+
+    return regressions;
+}
+
+static void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n\n"
+              << "  --trie=NAME[,NAME...]   tries to run (default standard,compressed,double_array)\n"
+              << "  --sizes=N[,N...]        dataset sizes (default 1000,10000,100000)\n"
+              << "  --queries=N             queries per search case (default 10000)\n"
+              << "  --repeats=N             samples per case (default 10)\n"
+              << "  --save=FILE             write all samples as a baseline\n"
+              << "  --compare=FILE          compare against a saved baseline, exit 1 on regression\n"
+              << "  --alpha=P               significance level (default 0.01)\n"
+              << "  --threshold=F           smallest slowdown that fails, 0.1 = 10% (default)\n"
+              << "  --confirm=N             reruns before a slowdown counts (default 2)\n\n"
+              << "Tries:";
+    for (const auto& entry : suite()) {
+        std::cout << " " << entry.first;
+    }
+    std::cout << "\n";
+}
+
+static bool parseOptions(int argc, char* argv[], Options& opts) {
+    auto splitList = [](const std::string& text) {
+        std::vector<std::string> items;
+        std::stringstream stream(text);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (!item.empty()) items.push_back(item);
+        }
+        return items;
+    };
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            size_t eq = arg.find('=');
+            std::string key = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (key == "--help" || key == "-h") {
+                printUsage(argv[0]);
+                std::exit(0);
+            } else if (key == "--trie") {
+                opts.tries = splitList(value);
+                for (const auto& name : opts.tries) {
+                    if (!suite().count(name)) {
+                        std::cerr << "Unknown trie: " << name << "\n";
+                        return false;
+                    }
+                }
+            } else if (key == "--sizes") {
+                opts.sizes.clear();
+                for (const auto& item : splitList(value)) {
+                    double size = std::stod(item);
+                    if (!(size >= 1)) {
+                        std::cerr << "Bad dataset size: " << item << "\n";
+                        return false;
+                    }
+                    opts.sizes.push_back(static_cast<size_t>(size));
+                }
+            } else if (key == "--queries") {
+                opts.queries = static_cast<size_t>(std::stod(value));
+            } else if (key == "--repeats") {
+                opts.repeats = std::stoi(value);
+            } else if (key == "--save") {
+                opts.saveFile = value;
+            } else if (key == "--compare") {
+                opts.compareFile = value;
+            } else if (key == "--alpha") {
+                opts.alpha = std::stod(value);
+            } else if (key == "--threshold") {
+                opts.threshold = std::stod(value);
+            } else if (key == "--confirm") {
+                opts.confirmRuns = std::stoi(value);
+            } else {
+                std::cerr << "Unknown option: " << arg << " (see --help)\n";
+                return false;
+            }
+        }
+    } catch (...) {
+        std::cerr << "Bad option value (see --help)\n";
+        return false;
+    }
+
+    if (opts.repeats < 2 || opts.queries == 0 || opts.sizes.empty()) {
+        std::cerr << "Need --repeats >= 2, --queries > 0 and at least one size\n";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    Options opts;
+    if (!parseOptions(argc, argv, opts)) {
+        return 2;
+    }
+
+    std::map<std::string, CaseResult> baseline;
+    if (!opts.compareFile.empty()) {
+        std::ifstream in(opts.compareFile);
+        if (!in.is_open()) {
+            std::cerr << "Could not read baseline " << opts.compareFile << "\n";
+            return 2;
+        }
+        for (const auto& result : readResults(in)) {
+            baseline[result.name] = result;
+        }
+    }
+
+    struct Group {
+        std::string trie;
+        const Workload* workload;
+        std::vector<CaseResult> cases;
+    };
+
+    std::vector<Workload> workloads;
+    workloads.reserve(opts.sizes.size());
+    std::vector<Group> groups;
+    for (size_t size : opts.sizes) {
+        workloads.push_back(makeWorkload(size, opts.queries));
+        for (const auto& name : opts.tries) {
+            std::cerr << "Running " << name << " at " << size << " keys..." << std::endl;
+            groups.push_back({name, &workloads.back(), runIsolated(name, workloads.back(), opts.repeats)});
+        }
+    }
+
+    // A shared or throttled machine can slow a whole stretch of the run.
+    // Anything that looks like a regression is measured again and the new
+    // samples are pooled with the old ones, so a slowdown is reported only
+    // if it still shows over all of them. Replacing the samples instead
+    // would let one lucky rerun hide a real regression.
+    for (auto& group : groups) {
+        for (int run = 0; run < opts.confirmRuns; run++) {
+            bool suspect = false;
+            for (const auto& result : group.cases) {
+                auto it = baseline.find(result.name);
+                suspect = suspect || (it != baseline.end() && judge(it->second, result, opts).regression);
+            }
+            if (!suspect) {
+                break;
+            }
+            std::cerr << "Re-running " << group.trie << " at " << group.workload->keys.size() << " keys..." << std::endl;
+            std::vector<CaseResult> rerun = runIsolated(group.trie, *group.workload, opts.repeats);
+            for (auto& result : group.cases) {
+                for (const auto& again : rerun) {
+                    if (again.name == result.name) {
+                        result.samples.insert(result.samples.end(), again.samples.begin(), again.samples.end());
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<CaseResult> results;
+    for (const auto& group : groups) {
+        results.insert(results.end(), group.cases.begin(), group.cases.end());
+    }
+
+    if (!opts.saveFile.empty()) {
+        std::ofstream out(opts.saveFile);
+        writeResults(out, results);
+        std::cerr << "Saved " << results.size() << " cases to " << opts.saveFile << "\n";
+    }
+
+    if (opts.compareFile.empty()) {
+        for (const auto& result : results) {
+            std::cout << std::left << std::setw(36) << result.name << std::right << std::fixed
+                      << std::setprecision(1) << std::setw(12) << result.median() << " ns/op\n";
+        }
+        return 0;
+    }
+
+    int regressions = compareResults(baseline, results, opts);
+    if (regressions > 0) {
+        std::cout << "\n" << regressions << " regression(s) against " << opts.compareFile << "\n";
+        return 1;
+    }
+    std::cout << "\nNo regressions against " << opts.compareFile << "\n";
+    return 0;
+}
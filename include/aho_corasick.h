@@ -0,0 +1,70 @@
+#ifndef AHO_CORASICK_H
+#define AHO_CORASICK_H
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+#include "double_array_trie.h"
+
+// Aho-Corasick multi-pattern matcher built on a DoubleArrayTrie.
+// The goto function is the double array itself; failure links, output
+// (dictionary suffix) links and state depths live in extra arrays indexed
+// by the same state numbers as base/check. One pass over the text reports
+// every occurrence of every pattern.
+template<typename Alphabet>
+class BasicAhoCorasick {
+private:
+    static constexpr int EMPTY = -1;
+
+    BasicDoubleArrayTrie<Alphabet> trie;
+    using Array = typename BasicDoubleArrayTrie<Alphabet>::Array;
+
+    Array fail;    // longest proper suffix that is also a trie state
+    Array output;  // next terminal state on the failure chain, EMPTY if none
+    Array depth;   // length of the string spelled by each state
+    std::array<int, Alphabet::size> rootGoto;  // complete root row, so failing never loops there
+    bool built;
+
+public:
+    // Called with the start offset and length of each match
+    using MatchCallback = std::function<void(size_t start, size_t length)>;
+
+    // Scan position carried between buffers of a stream
+    struct StreamState {
+        int state = 0;
+        size_t offset = 0;  // bytes consumed so far
+    };
+
+    BasicAhoCorasick();
+    ~BasicAhoCorasick() = default;
+
+    // Adding patterns invalidates the links until build() runs again
+    void insert(const std::string& pattern);
+    void build();
+    bool isBuilt() const { return built; }
+
+    bool search(const std::string& word) const { return trie.search(word); }
+    bool startsWith(const std::string& prefix) const { return trie.startsWith(prefix); }
+
+    // Reports all matches in text, offsets relative to the start of text
+    void scan(const std::string& text, const MatchCallback& onMatch) const;
+
+    // Same, for one buffer of a longer stream. Matches spanning buffer
+    // boundaries are found; offsets are relative to the start of the stream.
+    void scan(const char* data, size_t length, StreamState& stream, const MatchCallback& onMatch) const;
+
+    size_t getMemoryUsage() const;
+    size_t getNodeCount() const { return trie.getNodeCount(); }
+    size_t getWordCount() const { return trie.getWordCount(); }
+    TrieStats stats() const;
+
+    void clear();
+
+private:
+    int next(int state, int code) const;
+};
+
+using AhoCorasick = BasicAhoCorasick<ByteAlphabet>;
+
+#endif
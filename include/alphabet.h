@@ -0,0 +1,94 @@
+#ifndef ALPHABET_H
+#define ALPHABET_H
+
+#include <array>
+#include <string>
+
+// Alphabet policies - map key characters onto a dense code range 0..size-1
+// at compile time. Every trie is templated on one of these so that child
+// tables and double-array offsets only span the characters actually used.
+// toCode() returns -1 for characters outside the alphabet.
+
+// Full byte alphabet - keys are arbitrary bytes (the original behaviour)
+struct ByteAlphabet {
+    static constexpr int size = 256;
+
+    static constexpr int toCode(char c) { return static_cast<unsigned char>(c); }
+    static constexpr char toChar(int code) { return static_cast<char>(code); }
+};
+
+// Contiguous character range, e.g. Alphabet<'a', 'z'>
+template<char First, char Last>
+struct Alphabet {
+    static_assert(First <= Last, "Alphabet range is empty");
+
+    static constexpr int size = Last - First + 1;
+
+    static constexpr int toCode(char c) {
+        return (c >= First && c <= Last) ? c - First : -1;
+    }
+    static constexpr char toChar(int code) { return static_cast<char>(First + code); }
+};
+
+// Custom alphabet from a symbol list. Symbols must provide
+//   static constexpr char chars[] = "...";
+// listing the characters in code (and therefore sort) order.
+template<typename Symbols>
+struct MappedAlphabet {
+    static constexpr int size = sizeof(Symbols::chars) - 1;
+
+private:
+    static constexpr std::array<int, 256> buildTable() {
+        std::array<int, 256> table{};
+        for (int i = 0; i < 256; i++) {
+            table[i] = -1;
+        }
+        for (int code = 0; code < size; code++) {
+            table[static_cast<unsigned char>(Symbols::chars[code])] = code;
+        }
+        return table;
+    }
+
+    static constexpr std::array<int, 256> table = buildTable();
+
+public:
+    static constexpr int toCode(char c) { return table[static_cast<unsigned char>(c)]; }
+    static constexpr char toChar(int code) { return Symbols::chars[code]; }
+};
+
+struct DnaSymbols {
+    static constexpr char chars[] = "ACGT";
+};
+
+using LowercaseAlphabet = Alphabet<'a', 'z'>;
+using DnaAlphabet = MappedAlphabet<DnaSymbols>;
+
+// True if every character of the key belongs to the alphabet. The tries
+// drop keys that fail this on insert.
+template<typename AlphabetType>
+bool isValidKey(const std::string& key) {
+    for (char c : key) {
+        if (AlphabetType::toCode(c) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Smallest code whose character sorts at or after c, or size if there is
+// none. Lets a range scan seek past characters the alphabet doesn't have.
+template<typename AlphabetType>
+int lowerBoundCode(char c) {
+    int code = AlphabetType::toCode(c);
+    if (code >= 0) {
+        return code;
+    }
+    for (code = 0; code < AlphabetType::size; code++) {
+        if (static_cast<unsigned char>(AlphabetType::toChar(code)) > static_cast<unsigned char>(c)) {
+            break;
+        }
+    }
+    return code;
+}
+
+#endif
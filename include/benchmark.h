@@ -5,26 +5,96 @@
 #include <vector>
 #include <chrono>
 #include <functional>
+#include <random>
+#include <set>
 
 // Results from a benchmark run
 struct BenchmarkResult {
     std::string trieType;
-    size_t datasetSize;
+    std::string keySource;    // "random" or the key file name
+    size_t datasetSize = 0;
+    size_t wordCount = 0;     // distinct words actually stored
     
-    double insertionTime;     // microseconds
-    double searchTime;        // microseconds
-    double searchMissTime;    // microseconds for failed searches
+    double insertionTime = 0;     // microseconds (including trainTime and buildTime)
+    double trainTime = 0;         // microseconds spent training a key encoder before inserting
+    double buildTime = 0;         // microseconds spent in a post-insert build() step
+    double searchTime = 0;        // microseconds
+    double searchMissTime = 0;    // microseconds for failed searches
+    size_t searchCount = 0;       // number of hit queries timed
+    long long dtlbMisses = -1;    // dTLB load misses during the search workload, -1 if not measurable
+    size_t missCount = 0;         // number of miss queries timed
     
-    size_t memoryUsage;       // bytes
-    size_t nodeCount;
+    double fuzzyTime1 = 0;        // microseconds for fuzzy queries at distance 1
+    double fuzzyTime2 = 0;        // ... and at distance 2
+    size_t fuzzyCount = 0;        // fuzzy queries per distance
+    size_t fuzzyMatches = 0;      // matches found over both distances
+    double patternTime = 0;       // microseconds for wildcard pattern queries
+    size_t patternCount = 0;
+    size_t patternMatches = 0;
+    double rangeTime = 0;         // microseconds for paginated range scans
+    size_t rangeCount = 0;
+    size_t rangeKeys = 0;         // keys streamed by all range scans
+    double scanTime = 0;          // microseconds for a multi-pattern scan of the corpus
+    size_t scanBytes = 0;
+    size_t scanMatches = 0;
+    double tokenizeTime = 0;      // microseconds for greedy longest-match tokenizing of the corpus
+    size_t tokenCount = 0;
+    double countTime = 0;         // microseconds for countPrefix on short prefixes of search keys
+    double enumCountTime = 0;     // ... the same counts by enumerating the prefix with rangeScan
+    double rankTime = 0;          // microseconds for rank() of the search keys
+    double selectTime = 0;        // microseconds for select() of random positions
+    size_t countQueries = 0;      // queries per order-statistics operation
+    double encodeTime = 0;        // microseconds to encode the search keys, for encoded tries
+    size_t encodeCount = 0;
+    double encodedKeyRatio = 0;   // encoded / raw key bytes, 0 when keys are stored as is
+    double logReplayTime = 0;     // microseconds to reopen a durable trie from its log alone
+    double checkpointTime = 0;    // microseconds to write a checkpoint of every key
+    double recoveryTime = 0;      // microseconds to reopen from that checkpoint
+    size_t logBytes = 0;          // log size after inserting, before the checkpoint
+    size_t checkpointBytes = 0;
+    
+    size_t memoryUsage = 0;       // bytes
+    size_t nodeCount = 0;
+    size_t splits = 0;            // from stats(), 0 when counters are compiled out
+    size_t relocations = 0;
+    size_t bursts = 0;
+    double probesPerFindBase = 0;
+    double nodesPerLookup = 0;
     
     // calculated metrics
-    double avgInsertTime;
-    double avgSearchTime;
-    double memoryPerWord;
+    double avgInsertTime = 0;
+    double avgSearchTime = 0;
+    double avgMissTime = 0;
+    double avgFuzzy1Time = 0;
+    double avgFuzzy2Time = 0;
+    double avgPatternTime = 0;
+    double avgRangeTime = 0;      // per page
+    double dtlbMissesPerSearch = -1;
+    double scanThroughput = 0;    // GB/s
+    double tokensPerSecond = 0;
+    double avgCountTime = 0;
+    double avgEnumCountTime = 0;
+    double avgRankTime = 0;
+    double avgSelectTime = 0;
+    double avgEncodeTime = 0;
+    double memoryPerWord = 0;
     
     void calculateAverages();
-    void print() const;
+    
+    // Every field, for machine-readable output
+    static std::string csvHeader();
+    std::string toCsv() const;
+    std::string toJson() const;
+};
+
+class Benchmark;
+
+// Type-erased handle for one trie variant. New trie types only need an
+// entry in Benchmark::variants() to become available to the driver.
+struct TrieVariant {
+    std::string name;         // command-line name, e.g. "compressed"
+    std::string displayName;  // printed name, e.g. "Compressed Trie"
+    std::function<BenchmarkResult(Benchmark&)> run;
 };
 
 // Benchmark runner - loads data and runs tests on all tries
@@ -33,6 +103,15 @@ private:
     std::vector<std::string> dataset;
     std::vector<std::string> searchKeys;  // real words to search for
     std::vector<std::string> missKeys;    // words not in the dataset
+    std::vector<std::string> fuzzyKeys;   // real words with one random edit
+    std::vector<std::string> patterns;    // wildcard queries like "ap?l*"
+    size_t pageSize = 100;                // keys per range-scan page
+    std::string corpus;                   // text made of dataset words and noise
+    std::string keySource;
+    
+    std::set<std::string> workloads = {"search", "miss"};
+    size_t queryCount = 1000;
+    std::mt19937 rng{std::random_device{}()};
     
 public:
     Benchmark() = default;
@@ -40,24 +119,60 @@ public:
     void loadDictionary(const std::string& filename);
     void generateRandomStrings(size_t count, size_t minLen, size_t maxLen);
     void loadFromFile(const std::string& filename);
+    void truncateDataset(size_t count);
+    
+    // Workloads run after insertion (insertion is always timed)
+    void setWorkloads(const std::set<std::string>& names) { workloads = names; }
+    bool hasWorkload(const std::string& name) const { return workloads.count(name) > 0; }
+    void setQueryCount(size_t count) { queryCount = count; }
+    void setSeed(unsigned seed) { rng.seed(seed); }
     
     template<typename TrieType>
     BenchmarkResult run(const std::string& trieTypeName);
     
     size_t getDatasetSize() const { return dataset.size(); }
-    void clearDataset() { dataset.clear(); searchKeys.clear(); missKeys.clear(); }
+    void clearDataset();
+    
+    // All registered trie variants, in the order they are reported
+    static const std::vector<TrieVariant>& variants();
+    static const TrieVariant* findVariant(const std::string& name);
+    static std::vector<std::string> workloadNames();
     
     static size_t getCurrentMemoryUsage();
     
 private:
     void prepareSearchKeys(size_t sampleSize);
     void prepareMissKeys(size_t sampleSize);
+    void prepareFuzzyKeys(size_t sampleSize);
+    void preparePatterns(size_t sampleSize);
+    void prepareCorpus(size_t bytes);
     
     template<typename TrieType>
     double measureInsertionTime(TrieType& trie);
     
     template<typename TrieType>
     double measureSearchTime(const TrieType& trie, const std::vector<std::string>& keys);
+    
+    template<typename TrieType>
+    double measureFuzzyTime(const TrieType& trie, int maxDistance, size_t& matches);
+    
+    template<typename TrieType>
+    double measurePatternTime(const TrieType& trie, size_t& matches);
+    
+    template<typename TrieType>
+    double measureRangeTime(const TrieType& trie, size_t& keys);
+    
+    template<typename TrieType>
+    double measureScanTime(const TrieType& trie, size_t& matches);
+    
+    template<typename TrieType>
+    double measureTokenizeTime(const TrieType& trie, size_t& tokens);
+    
+    template<typename TrieType>
+    void measureOrderStatistics(const TrieType& trie, BenchmarkResult& result);
+    
+    template<typename TrieType>
+    void measureRestart(TrieType& trie, const std::string& directory, BenchmarkResult& result);
 };
 
 // Simple timer for measuring operations
@@ -79,4 +194,22 @@ public:
     }
 };
 
+// Counts dTLB load misses of this process with perf_event_open.
+// available() is false where the counter can't be opened (not Linux,
+// perf locked down, no PMU exposed to a VM).
+class TlbMissCounter {
+private:
+    int fd;
+    
+public:
+    TlbMissCounter();
+    ~TlbMissCounter();
+    TlbMissCounter(const TlbMissCounter&) = delete;
+    TlbMissCounter& operator=(const TlbMissCounter&) = delete;
+    
+    bool available() const { return fd >= 0; }
+    void start();
+    long long stop();  // misses since start(), -1 if unavailable
+};
+
 #endif
@@ -0,0 +1,82 @@
+#ifndef BURST_TRIE_H
+#define BURST_TRIE_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <vector>
+#include "alphabet.h"
+#include "child_table.h"
+#include "packed_strings.h"
+#include "range_scan.h"
+#include "trie_stats.h"
+
+// Burst Trie (Heinz, Zobel & Williams 2002) - trie nodes on top, small
+// containers at the leaves. A container holds the suffixes of all keys
+// below it in one sorted, length-prefixed byte buffer, so the long
+// single-child chains near the leaves of a standard trie cost a few bytes
+// per key instead of a node per character. A container that grows past
+// BURST_THRESHOLD keys bursts: it becomes a trie node and its suffixes
+// move, minus their first character, into new child containers.
+template<typename Alphabet>
+class BasicBurstTrie {
+private:
+    static constexpr uint32_t BURST_THRESHOLD = 64;
+
+    struct TrieNode {
+        ChildTable<TrieNode, Alphabet::size> children;
+        std::string bucket;    // sorted suffixes, see packed_strings.h
+        uint32_t bucketCount;  // suffixes in bucket
+        bool isContainer;      // false once burst
+        bool isEndOfWord;      // the key ending right here, never stored in bucket
+
+        explicit TrieNode(bool container) : bucketCount(0), isContainer(container), isEndOfWord(false) {}
+    };
+
+    std::unique_ptr<TrieNode> root;
+    size_t wordCount;
+    size_t nodeCount;
+    size_t memoryBytes;  // nodes, child arrays and container buffers
+
+    StatCounter bursts;
+    mutable StatCounter lookups;
+    mutable StatCounter nodesVisited;
+
+public:
+    BasicBurstTrie();
+    ~BasicBurstTrie() = default;
+
+    void insert(const std::string& word);
+    bool search(const std::string& word) const;
+    bool startsWith(const std::string& prefix) const;
+    bool remove(const std::string& word);
+
+    // Ordered scans, see range_scan.h. Containers keep their suffixes
+    // sorted, so a scan seeks into the one holding lo.
+    using KeyCallback = ScanCallback;
+    void rangeScan(const std::string& lo, const std::string& hi, const KeyCallback& onKey) const;
+
+    std::string lowerBound(const std::string& key) const { return lowerBoundByScan(*this, key); }
+
+    size_t getMemoryUsage() const { return memoryBytes; }
+    size_t getNodeCount() const { return nodeCount; }
+    size_t getWordCount() const { return wordCount; }
+    TrieStats stats() const;
+
+    void clear();
+    std::vector<std::string> getAllWords() const;
+
+private:
+    const TrieNode* descend(const std::string& key, size_t& depth) const;
+    TrieNode* addChild(TrieNode* node, int code);
+    void burst(TrieNode* node);
+    bool rangeScanHelper(const TrieNode* node, bool tight, const std::string& lo, const std::string& hi,
+                         std::string& word, const KeyCallback& onKey) const;
+    static size_t bucketBytes(const TrieNode* node);
+    static size_t seekEntry(const std::string& bucket, std::string_view key, bool& found);
+};
+
+using BurstTrie = BasicBurstTrie<ByteAlphabet>;
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef CHILD_TABLE_H
+#define CHILD_TABLE_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Child table for pointer-based tries, indexed by alphabet code.
+// A fixed-size occupancy bitmap (one bit per code) answers "is there a
+// child for this code" and its rank gives the slot in a packed array of
+// children kept in code order. Lookups are O(1) like a K-slot pointer
+// array, but a node only pays for the children it actually has.
+template<typename Node, int AlphabetSize>
+class ChildTable {
+private:
+    static constexpr int WORDS = (AlphabetSize + 63) / 64;
+
+    std::array<uint64_t, WORDS> mask{};
+    std::vector<std::unique_ptr<Node>> slots;
+
+    bool has(int code) const {
+        return (mask[code >> 6] >> (code & 63)) & 1;
+    }
+
+    // number of children with a smaller code
+    size_t rank(int code) const {
+        size_t r = 0;
+        for (int w = 0; w < (code >> 6); w++) {
+            r += __builtin_popcountll(mask[w]);
+        }
+        uint64_t below = (uint64_t(1) << (code & 63)) - 1;
+        return r + __builtin_popcountll(mask[code >> 6] & below);
+    }
+
+public:
+    Node* find(int code) const {
+        if (static_cast<unsigned>(code) >= static_cast<unsigned>(AlphabetSize) || !has(code)) {
+            return nullptr;
+        }
+        return slots[rank(code)].get();
+    }
+
+    // Adds a child for a code that is not present yet, returns the raw pointer
+    Node* insert(int code, std::unique_ptr<Node> child) {
+        Node* raw = child.get();
+        slots.insert(slots.begin() + rank(code), std::move(child));
+        mask[code >> 6] |= uint64_t(1) << (code & 63);
+        return raw;
+    }
+
+    // Removes the child for code and hands it back, null if there was none
+    std::unique_ptr<Node> erase(int code) {
+        if (static_cast<unsigned>(code) >= static_cast<unsigned>(AlphabetSize) || !has(code)) {
+            return nullptr;
+        }
+        size_t slot = rank(code);
+        std::unique_ptr<Node> child = std::move(slots[slot]);
+        slots.erase(slots.begin() + slot);
+        mask[code >> 6] &= ~(uint64_t(1) << (code & 63));
+        return child;
+    }
+
+    // Calls f(code, child) for every child in ascending code order
+    template<typename F>
+    void forEach(F&& f) const {
+        size_t i = 0;
+        for (int w = 0; w < WORDS; w++) {
+            uint64_t bits = mask[w];
+            while (bits) {
+                int code = w * 64 + __builtin_ctzll(bits);
+                f(code, slots[i++].get());
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    // Calls f(code, child) for the children with code >= firstCode, in
+    // order, until f returns false. Returns false if it was stopped early.
+    template<typename F>
+    bool forEachFrom(int firstCode, F&& f) const {
+        if (firstCode >= AlphabetSize) {
+            return true;
+        }
+        if (firstCode < 0) {
+            firstCode = 0;
+        }
+
+        size_t i = rank(firstCode);
+        for (int w = firstCode >> 6; w < WORDS; w++) {
+            uint64_t bits = mask[w];
+            if (w == (firstCode >> 6)) {
+                bits &= ~((uint64_t(1) << (firstCode & 63)) - 1);
+            }
+            while (bits) {
+                int code = w * 64 + __builtin_ctzll(bits);
+                if (!f(code, slots[i++].get())) {
+                    return false;
+                }
+                bits &= bits - 1;
+            }
+        }
+        return true;
+    }
+
+    size_t size() const { return slots.size(); }
+    bool empty() const { return slots.empty(); }
+
+    // heap bytes held by the packed child array
+    size_t heapBytes() const { return slots.capacity() * sizeof(std::unique_ptr<Node>); }
+
+    void clear() {
+        mask.fill(0);
+        slots.clear();
+    }
+};
+
+#endif
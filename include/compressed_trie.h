@@ -1,50 +1,140 @@
 #ifndef COMPRESSED_TRIE_H
 #define COMPRESSED_TRIE_H
 
+#include <functional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <memory>
 #include <vector>
+#include "alphabet.h"
+#include "levenshtein.h"
+#include "glob_pattern.h"
+#include "child_table.h"
+#include "double_array_trie.h"
+#include "flat_trie.h"
+#include "range_scan.h"
+#include "trie_stats.h"
 
 // Compressed Trie (Radix Tree) - merges single-child paths into edges
 // Better memory usage than standard trie. Also called Patricia tree.
-class CompressedTrie {
+// Children are indexed by the alphabet code of their edge's first character.
+template<typename Alphabet>
+class BasicCompressedTrie {
 private:
     struct TrieNode {
-        std::unordered_map<char, std::unique_ptr<TrieNode>> children;
+        ChildTable<TrieNode, Alphabet::size> children;
         std::string edgeLabel;  // The path to this node is stored as a string
+        uint32_t wordsBelow;    // keys ending at or below this node
         bool isEndOfWord;
-        
-        TrieNode() : isEndOfWord(false) {}
+
+        TrieNode() : wordsBelow(0), isEndOfWord(false) {}
     };
-    
+
     std::unique_ptr<TrieNode> root;
     size_t wordCount;
     size_t nodeCount;
-    
+    size_t memoryBytes;  // sum of nodeBytes() over all nodes
+
+    StatCounter splits;
+    mutable StatCounter lookups;
+    mutable StatCounter nodesVisited;
+
 public:
-    CompressedTrie();
-    ~CompressedTrie() = default;
-    
+    BasicCompressedTrie();
+    ~BasicCompressedTrie() = default;
+
     void insert(const std::string& word);
     bool search(const std::string& word) const;
     bool startsWith(const std::string& prefix) const;
     bool remove(const std::string& word);
-    
-    size_t getMemoryUsage() const;
+
+    // Words within maxDistance edits of the query. Edge labels are fed to the
+    // automaton one character at a time, so pruning can stop mid-edge.
+    std::vector<FuzzyMatch> fuzzySearch(const std::string& query, int maxDistance) const;
+
+    // Words matching a wildcard pattern (?, *, [a-z], [^...])
+    std::vector<std::string> matchPattern(const std::string& pattern) const;
+
+    // Keys that are prefixes of input, found in one walk from the root.
+    // onMatch(size_t length) is called for each one, shortest first.
+    template<typename OnMatch>
+    void commonPrefixSearch(std::string_view input, OnMatch&& onMatch) const;
+
+    // Length of the longest key that is a prefix of input, 0 if there is none
+    size_t longestPrefixMatch(std::string_view input) const;
+
+    // Ordered scans, see range_scan.h. Each edge label is compared with lo
+    // as a whole, so a subtree is skipped or entered in one step.
+    using KeyCallback = ScanCallback;
+    void rangeScan(const std::string& lo, const std::string& hi, const KeyCallback& onKey) const;
+
+    std::string lowerBound(const std::string& key) const { return lowerBoundByScan(*this, key); }
+
+    // Order statistics from the per-node key counts. countPrefix is one
+    // walk down the prefix; rank and select also add up the counts of
+    // the siblings they pass.
+    size_t countPrefix(const std::string& prefix) const;
+    size_t rank(const std::string& key) const;       // keys < key
+    std::string select(size_t index) const;          // index-th key in order, empty if out of range
+
+    size_t getMemoryUsage() const { return memoryBytes; }
     size_t getNodeCount() const { return nodeCount; }
     size_t getWordCount() const { return wordCount; }
+    TrieStats stats() const;
     double getCompressionRatio() const;
-    
+
+    // Read-only copy as a double array, built in one breadth-first walk.
+    // Edge labels unroll into chains of single-child states.
+    BasicDoubleArrayTrie<Alphabet> freeze() const;
+
+    // Read-only copy in one contiguous buffer, laid out for lookups
+    // (see BasicFlatTrie)
+    BasicFlatTrie<Alphabet> relayout() const;
+
     void clear();
     std::vector<std::string> getAllWords() const;
-    
+
 private:
-    void getAllWordsHelper(const TrieNode* node, std::string currentWord, 
+    void getAllWordsHelper(const TrieNode* node, std::string currentWord,
                           std::vector<std::string>& words) const;
-    size_t calculateMemoryUsage(const TrieNode* node) const;
-    int matchingPrefixLength(const std::string& str1, const std::string& str2) const;
-    void splitNode(TrieNode* node, int splitPos);
+    static size_t nodeBytes(const TrieNode* node);
+    void fuzzySearchHelper(const TrieNode* node, const LevenshteinAutomaton& automaton, std::vector<int>& rows,
+                           std::string& word, std::vector<FuzzyMatch>& matches) const;
+    void matchPatternHelper(const TrieNode* node, const GlobPattern& glob, std::vector<uint64_t>& states,
+                            std::string& word, std::vector<std::string>& matches) const;
+    size_t matchingPrefixLength(const std::string& str1, const std::string& str2) const;
+    void splitNode(TrieNode* node, size_t splitPos);
+    void addToCounts(const std::string& key, int delta);
+    bool rangeScanHelper(const TrieNode* node, bool tight, const std::string& lo, const std::string& hi,
+                         std::string& word, const KeyCallback& onKey) const;
 };
 
+// A key can only end at a node, so each edge label is either consumed
+// whole or ends the walk
+template<typename Alphabet>
+template<typename OnMatch>
+void BasicCompressedTrie<Alphabet>::commonPrefixSearch(std::string_view input, OnMatch&& onMatch) const {
+    const TrieNode* current = root.get();
+    size_t pos = 0;
+
+    while (pos < input.size()) {
+        current = current->children.find(Alphabet::toCode(input[pos]));
+        if (!current) {
+            return;
+        }
+
+        const std::string& label = current->edgeLabel;
+        if (input.size() - pos < label.size() || input.compare(pos, label.size(), label) != 0) {
+            return;
+        }
+
+        pos += label.size();
+        if (current->isEndOfWord) {
+            onMatch(pos);
+        }
+    }
+}
+
+using CompressedTrie = BasicCompressedTrie<ByteAlphabet>;
+
 #endif
@@ -0,0 +1,98 @@
+#ifndef DAWG_H
+#define DAWG_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "alphabet.h"
+#include "range_scan.h"
+#include "trie_stats.h"
+
+// DAWG - minimal acyclic automaton for a key set (Daciuk, Mihov, Watson
+// & Watson 2000). A trie shares prefixes only; the DAWG also merges every
+// pair of states with the same future, so "-ing", "-tion" or ".com"
+// endings are stored once. Keys have to arrive in sorted order: then only
+// the path of the previous key can still change, and its states are
+// minimized bottom-up against a register of the states already final
+// as soon as the next key leaves that path.
+//
+// build() seals the automaton and packs it into flat arrays, one range
+// of (code, target) edges per state. Queries need build() first.
+template<typename Alphabet>
+class BasicDawg {
+private:
+    static constexpr uint32_t NO_STATE = UINT32_MAX;
+    static constexpr uint32_t LINEAR_SEARCH_MAX = 16;
+
+    // While building
+    struct BuildState {
+        std::vector<std::pair<uint8_t, uint32_t>> edges;  // code and target, in code order
+        bool isFinal = false;
+    };
+
+    std::vector<BuildState> building;
+    std::vector<uint32_t> recycled;  // building slots of states merged away
+    std::unordered_multimap<size_t, uint32_t> registry;  // minimized states by hash
+    std::vector<uint32_t> path;      // states of the previous key, root first
+    std::string previous;
+    bool sealed;
+
+    // After build(): the edges of state s are firstEdge[s] .. firstEdge[s + 1]
+    std::vector<uint32_t> firstEdge;
+    std::vector<uint8_t> edgeCodes;
+    std::vector<uint32_t> edgeTargets;
+    std::vector<bool> finalStates;
+
+    size_t wordCount;
+
+    mutable StatCounter lookups;
+    mutable StatCounter nodesVisited;
+
+public:
+    BasicDawg();
+    ~BasicDawg() = default;
+
+    // Keys must come in ascending order. One that is not greater than the
+    // previous key, or that arrives after build(), is ignored.
+    void insert(const std::string& word);
+    void build();
+
+    bool search(const std::string& word) const;
+    bool startsWith(const std::string& prefix) const;
+
+    // Length of the longest key that is a prefix of input, 0 if there is none
+    size_t longestPrefixMatch(std::string_view input) const;
+
+    // Ordered scans, see range_scan.h. A shared state is walked once for
+    // every path into it, so a scan costs what it would on the trie.
+    using KeyCallback = ScanCallback;
+    void rangeScan(const std::string& lo, const std::string& hi, const KeyCallback& onKey) const;
+
+    std::string lowerBound(const std::string& key) const { return lowerBoundByScan(*this, key); }
+
+    size_t getMemoryUsage() const;
+    size_t getNodeCount() const { return sealed ? firstEdge.size() - 1 : building.size() - recycled.size(); }
+    size_t getEdgeCount() const { return edgeTargets.size(); }
+    size_t getWordCount() const { return wordCount; }
+    TrieStats stats() const;
+
+    void clear();
+    std::vector<std::string> getAllWords() const;
+
+private:
+    uint32_t newState();
+    void minimize(size_t depth);
+    size_t hashState(uint32_t id) const;
+    bool sameState(uint32_t a, uint32_t b) const;
+    uint32_t step(uint32_t state, int code) const;
+    bool rangeScanHelper(uint32_t state, bool tight, const std::string& lo, const std::string& hi,
+                         std::string& word, const KeyCallback& onKey) const;
+};
+
+using Dawg = BasicDawg<ByteAlphabet>;
+
+#endif
@@ -1,47 +1,136 @@
 #ifndef DOUBLE_ARRAY_TRIE_H
 #define DOUBLE_ARRAY_TRIE_H
 
+#include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_set>
+#include "alphabet.h"
+#include "levenshtein.h"
+#include "glob_pattern.h"
+#include "huge_page_allocator.h"
+#include "range_scan.h"
+#include "trie_stats.h"
 
 // Double-Array Trie - very memory efficient but complex to implement
 // Uses two arrays: base[] and check[] for state transitions
-// More complex but provides best memory usage
-class DoubleArrayTrie {
+// Transitions are offset by alphabet code, so a small alphabet packs
+// child blocks much more densely than raw byte values would.
+template<typename Alphabet>
+class BasicDoubleArrayTrie {
 private:
     static constexpr int INITIAL_SIZE = 10000;
     static constexpr int EMPTY = -1;
-    
-    std::vector<int> base;   // base array
-    std::vector<int> check;  // check array
-    std::vector<bool> used;  // track which positions are used
+    static constexpr size_t BULK_PROBE_LIMIT = 64;
+
+    // Free slots form a circular doubly-linked list threaded through the
+    // arrays themselves: check[i] = -(next + 1), base[i] = -(prev + 1).
+    // Both arrays come from HugePageAllocator, see PagePolicy
+    using Array = std::vector<int, HugePageAllocator<int>>;
+
+    Array base;   // base array (negative = end of word)
+    Array check;  // check array (parent state, negative if free)
     size_t wordCount;
+    size_t stateCount;
     size_t maxState;
-    
+    int freeHead;            // first free slot, EMPTY if none
+
+    StatCounter relocations;
+    StatCounter findBaseCalls;
+    StatCounter findBaseProbes;
+    mutable StatCounter lookups;
+    mutable StatCounter nodesVisited;
+
+    // Automata layered on top of the arrays (failure links etc.)
+    template<typename> friend class BasicAhoCorasick;
+
+    // Pointer tries that freeze() into a double array through the bulk
+    // placement helpers below
+    template<typename> friend class BasicStandardTrie;
+    template<typename> friend class BasicCompressedTrie;
+
 public:
-    DoubleArrayTrie();
-    ~DoubleArrayTrie() = default;
-    
+    BasicDoubleArrayTrie();
+    ~BasicDoubleArrayTrie() = default;
+
     void insert(const std::string& word);
     bool search(const std::string& word) const;
     bool startsWith(const std::string& prefix) const;
-    
+
+    // Words within maxDistance edits of the query, with their distances
+    std::vector<FuzzyMatch> fuzzySearch(const std::string& query, int maxDistance) const;
+
+    // Words matching a wildcard pattern (?, *, [a-z], [^...])
+    std::vector<std::string> matchPattern(const std::string& pattern) const;
+
+    // Keys that are prefixes of input, found in one walk from the root.
+    // onMatch(size_t length) is called for each one, shortest first. It is
+    // a template parameter, so the walk neither allocates nor calls
+    // through a pointer.
+    template<typename OnMatch>
+    void commonPrefixSearch(std::string_view input, OnMatch&& onMatch) const;
+
+    // Length of the longest key that is a prefix of input, 0 if there is none
+    size_t longestPrefixMatch(std::string_view input) const;
+
+    // Ordered scans, see range_scan.h. The arrays don't list a state's
+    // children, so the scan probes every code from lo's character up.
+    using KeyCallback = ScanCallback;
+    void rangeScan(const std::string& lo, const std::string& hi, const KeyCallback& onKey) const;
+
+    std::string lowerBound(const std::string& key) const { return lowerBoundByScan(*this, key); }
+
     size_t getMemoryUsage() const;
     size_t getArraySize() const { return base.size(); }
     size_t getWordCount() const { return wordCount; }
-    size_t getNodeCount() const { return maxState + 1; }
+    size_t getNodeCount() const { return stateCount; }
     double getSpaceEfficiency() const;
-    
+    TrieStats stats() const;
+
     void clear();
     void compact();
-    
+
 private:
-    int findBase(int state, const std::unordered_set<char>& chars);
+    int baseOf(int state) const { return base[state] < 0 ? -base[state] - 1 : base[state]; }
+    bool isFree(size_t pos) const { return pos >= check.size() || check[pos] < 0; }
+
+    int findBase(const std::vector<int>& codes);
+    void relocate(int state, int newBase, const std::vector<int>& codes);
     void resize(size_t newSize);
-    int getTransition(int state, char c) const;
-    void setTransition(int state, char c, int nextState);
-    bool isValidTransition(int state, char c, int nextState) const;
+    void ensureSize(size_t pos);
+    void linkFree(int pos, bool atHead);
+    void unlinkFree(int pos);
+    void rebuildFreeList();
+    int addTransition(int state, int code);
+    int getTransition(int state, int code) const;
+    void setTransition(int state, int nextState);
+    int placeChildren(int state, const std::vector<int>& codes);
+    int findBulkBase(const std::vector<int>& codes);
+    void markEndOfWord(int state);
+    void fuzzySearchHelper(int state, const LevenshteinAutomaton& automaton, std::vector<int>& rows,
+                           std::string& word, std::vector<FuzzyMatch>& matches) const;
+    void matchPatternHelper(int state, const GlobPattern& glob, std::vector<uint64_t>& states,
+                            std::string& word, std::vector<std::string>& matches) const;
+    bool rangeScanHelper(int state, bool tight, const std::string& lo, const std::string& hi,
+                         std::string& word, const KeyCallback& onKey) const;
 };
 
+template<typename Alphabet>
+template<typename OnMatch>
+void BasicDoubleArrayTrie<Alphabet>::commonPrefixSearch(std::string_view input, OnMatch&& onMatch) const {
+    int state = 0;
+
+    for (size_t i = 0; i < input.size(); i++) {
+        state = getTransition(state, Alphabet::toCode(input[i]));
+        if (state == EMPTY) {
+            return;
+        }
+        if (base[state] < 0) {
+            onMatch(i + 1);
+        }
+    }
+}
+
+using DoubleArrayTrie = BasicDoubleArrayTrie<ByteAlphabet>;
+
 #endif
@@ -0,0 +1,106 @@
+#ifndef DURABLE_TRIE_H
+#define DURABLE_TRIE_H
+
+#include <cstdint>
+#include <string>
+#include "trie_stats.h"
+
+struct DurabilityOptions {
+    size_t groupCommitRecords = 256;       // log records buffered per write + sync
+    size_t checkpointLogBytes = 64 << 20;  // log size that triggers a checkpoint
+    bool sync = true;                      // fdatasync each commit; off survives crashes of the process only
+};
+
+// What open() found on disk
+struct RecoveryInfo {
+    size_t checkpointKeys = 0;
+    size_t replayedRecords = 0;
+    size_t discardedBytes = 0;  // torn or corrupt log tail that was cut off
+};
+
+// Keeps a mutable trie recoverable across restarts. Every insert or
+// remove that changes the key set is appended to a write-ahead log in the
+// directory given to open(); records are buffered and written with one
+// sync per group, so a crash loses at most the last uncommitted group.
+// Once the log passes checkpointLogBytes the whole key set is written as
+// a checkpoint (sorted, front coded) and the log starts over. open()
+// loads the checkpoint and replays the log after it, so a restart costs
+// one sequential read of about the trie's key bytes plus a short tail.
+//
+// Each log record sets one key's membership, so replaying a record the
+// checkpoint already contains is harmless; a crash between writing the
+// checkpoint and truncating the log just replays a longer tail.
+//
+// Files are in native byte order. After a failed write or sync the
+// object stops logging and commit() and checkpoint() return false; the
+// in-memory trie stays usable.
+template<typename TrieType>
+class DurableTrie {
+private:
+    TrieType trie;
+    DurabilityOptions options;
+    std::string directory;
+    int logFd;
+    std::string pending;  // encoded records not yet written
+    size_t pendingRecords;
+    size_t logBytes;      // written to the log since the last checkpoint
+    size_t checkpointBytes;
+    bool failed;
+    RecoveryInfo recovery;
+
+public:
+    DurableTrie();
+    ~DurableTrie();
+    DurableTrie(const DurableTrie&) = delete;
+    DurableTrie& operator=(const DurableTrie&) = delete;
+
+    // Creates directory if needed and recovers the keys stored there.
+    // False if the checkpoint is unreadable or the log can't be opened.
+    bool open(const std::string& path, const DurabilityOptions& opts = DurabilityOptions());
+
+    // Commits and closes the log; the trie stays queryable
+    bool close();
+
+    void insert(const std::string& word);
+    bool remove(const std::string& word);
+
+    // Writes and syncs the buffered records
+    bool commit();
+
+    // Commits, then replaces the checkpoint with the current key set and
+    // empties the log
+    bool checkpoint();
+
+    bool search(const std::string& word) const { return trie.search(word); }
+    bool startsWith(const std::string& prefix) const { return trie.startsWith(prefix); }
+
+    using KeyCallback = typename TrieType::KeyCallback;
+    void rangeScan(const std::string& lo, const std::string& hi, const KeyCallback& onKey) const {
+        trie.rangeScan(lo, hi, onKey);
+    }
+    std::string lowerBound(const std::string& key) const { return trie.lowerBound(key); }
+
+    const TrieType& getTrie() const { return trie; }
+    const RecoveryInfo& getRecoveryInfo() const { return recovery; }
+    size_t getLogBytes() const { return logBytes + pending.size(); }
+    size_t getCheckpointBytes() const { return checkpointBytes; }
+
+    size_t getMemoryUsage() const { return trie.getMemoryUsage() + pending.capacity(); }
+    size_t getNodeCount() const { return trie.getNodeCount(); }
+    size_t getWordCount() const { return trie.getWordCount(); }
+    TrieStats stats() const;
+
+private:
+    std::string logPath() const { return directory + "/wal"; }
+    std::string checkpointPath() const { return directory + "/checkpoint"; }
+    void append(uint8_t op, const std::string& word);
+    bool loadCheckpoint();
+    bool replayLog();
+    bool flush();
+    bool writeAll(int fd, const char* data, size_t size);
+    bool syncFile(int fd);
+    bool syncDirectory();
+    bool fail(const std::string& what);
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef ENCODED_TRIE_H
+#define ENCODED_TRIE_H
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "key_encoder.h"
+#include "trie_stats.h"
+
+// Any byte-alphabet trie behind a KeyEncoder. Keys are compressed on the
+// way in and decoded on the way out; since the encoding preserves order,
+// lowerBound, prefix checks and range scans map straight onto the inner
+// trie. Edit-distance and wildcard queries don't survive the encoding and
+// are not offered.
+template<typename TrieType>
+class EncodedTrie {
+private:
+    KeyEncoder encoder;
+    TrieType trie;
+
+public:
+    EncodedTrie() = default;
+
+    // Trains the encoder on sample. Keys already stored are re-encoded,
+    // but training before the first insert avoids that rebuild.
+    void train(const std::vector<std::string>& sample);
+
+    void insert(const std::string& word);
+    bool search(const std::string& word) const;
+    bool startsWith(const std::string& prefix) const;
+
+    using KeyCallback = std::function<bool(const std::string& key)>;
+    void rangeScan(const std::string& lo, const std::string& hi, const KeyCallback& onKey) const;
+    std::string lowerBound(const std::string& key) const;
+
+    // Only for inner tries that have their own finishing pass
+    template<typename T = TrieType>
+    auto compact() -> decltype(std::declval<T&>().compact()) { return trie.compact(); }
+
+    const KeyEncoder& getEncoder() const { return encoder; }
+    const TrieType& getTrie() const { return trie; }
+
+    size_t getMemoryUsage() const { return trie.getMemoryUsage() + encoder.getMemoryUsage(); }
+    size_t getNodeCount() const { return trie.getNodeCount(); }
+    size_t getWordCount() const { return trie.getWordCount(); }
+    TrieStats stats() const;
+
+    void clear();
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef FLAT_TRIE_H
+#define FLAT_TRIE_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "alphabet.h"
+#include "huge_page_allocator.h"
+#include "range_scan.h"
+#include "trie_stats.h"
+
+// Read-only trie copied into one contiguous buffer, children addressed by
+// byte offsets instead of pointers. The top of the trie is stored breadth
+// first until HOT_BYTES are used, so the levels every lookup passes
+// through sit together in cache. Below that each subtree is stored depth
+// first in one piece, and a lookup's path down it stays on a few pages
+// instead of wherever the allocator put each node during the inserts.
+// Built by relayout() on the standard and compressed tries. Offsets are
+// 32 bits, so a layout past 4 GB throws std::length_error.
+template<typename Alphabet>
+class BasicFlatTrie {
+private:
+    static constexpr size_t HOT_BYTES = 256 * 1024;
+    static constexpr uint16_t LINEAR_SEARCH_MAX = 16;
+    static constexpr size_t NO_SLOT = SIZE_MAX;
+
+    // A node is its header, the rest of its edge label (the first
+    // character is the child's code in the parent), its child codes in
+    // order, padding to 4 bytes and then one uint32_t offset per child.
+    // Every node starts 4-byte aligned.
+    struct NodeHeader {
+        uint32_t labelLength;
+        uint16_t childCount;
+        uint8_t isEndOfWord;
+        uint8_t unused;
+    };
+
+    using Buffer = std::vector<uint8_t, HugePageAllocator<uint8_t>>;
+
+    Buffer buffer;
+    size_t wordCount;
+    size_t nodeCount;
+
+    mutable StatCounter lookups;
+    mutable StatCounter nodesVisited;
+
+    // What relayout() reports about one node of the source trie
+    struct SourceNode {
+        std::string_view label;  // edge label minus its first character
+        bool isEndOfWord = false;
+        std::vector<std::pair<int, const void*>> children;  // code and node, in code order
+    };
+    using Describe = std::function<void(const void* node, SourceNode& out)>;
+
+    template<typename> friend class BasicStandardTrie;
+    template<typename> friend class BasicCompressedTrie;
+
+public:
+    BasicFlatTrie();
+    ~BasicFlatTrie() = default;
+
+    bool search(const std::string& word) const;
+    bool startsWith(const std::string& prefix) const;
+
+    // Length of the longest key that is a prefix of input, 0 if there is none
+    size_t longestPrefixMatch(std::string_view input) const;
+
+    // Ordered scans, see range_scan.h. Edges are stored in code order, so
+    // a node's children are read front to back.
+    using KeyCallback = ScanCallback;
+    void rangeScan(const std::string& lo, const std::string& hi, const KeyCallback& onKey) const;
+
+    std::string lowerBound(const std::string& key) const { return lowerBoundByScan(*this, key); }
+
+    size_t getMemoryUsage() const { return buffer.capacity(); }
+    size_t getNodeCount() const { return nodeCount; }
+    size_t getWordCount() const { return wordCount; }
+    TrieStats stats() const;
+
+    void clear();
+    std::vector<std::string> getAllWords() const;
+
+private:
+    const NodeHeader* header(size_t node) const { return reinterpret_cast<const NodeHeader*>(&buffer[node]); }
+    const uint8_t* codesOf(size_t node) const { return &buffer[node + sizeof(NodeHeader) + header(node)->labelLength]; }
+    const uint32_t* offsetsOf(size_t node) const;
+    std::string_view labelOf(size_t node) const;
+    size_t findChild(size_t node, int code) const;
+
+    void build(const void* root, const Describe& describe);
+    void emit(const void* source, size_t slot, const Describe& describe, SourceNode& scratch,
+              std::vector<std::pair<const void*, size_t>>& pending);
+    bool rangeScanHelper(size_t node, bool tight, const std::string& lo, const std::string& hi,
+                         std::string& word, const KeyCallback& onKey) const;
+};
+
+using FlatTrie = BasicFlatTrie<ByteAlphabet>;
+
+#endif
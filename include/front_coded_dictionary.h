@@ -0,0 +1,70 @@
+#ifndef FRONT_CODED_DICTIONARY_H
+#define FRONT_CODED_DICTIONARY_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "packed_strings.h"
+#include "range_scan.h"
+#include "trie_stats.h"
+
+// Not a trie: the keys sorted into one buffer with front coding, the
+// baseline the tries have to beat on bytes per key. Keys come in blocks
+// of BLOCK_SIZE. The first key of a block is stored whole, and each
+// following one as the length it shares with the key before it plus
+// the rest of its bytes (LEB128 numbers, see packed_strings.h). A lookup
+// binary searches the block heads through the sampled offsets, then
+// decodes at most one block front to back. Block offsets are 64-bit:
+// the buffer passes 4 GB at about 100M keys.
+//
+// insert() only collects keys; build() sorts them into the buffer,
+// merged with whatever was encoded before. Queries see the keys of the
+// last build() only.
+class FrontCodedDictionary {
+private:
+    static constexpr size_t BLOCK_SIZE = 16;
+
+    std::string data;                   // the blocks, back to back
+    std::vector<uint64_t> blockOffsets; // where each block starts in data
+    std::vector<std::string> pending;   // inserted since the last build()
+    size_t wordCount;
+
+    mutable StatCounter lookups;
+    mutable StatCounter nodesVisited;  // keys decoded
+
+public:
+    FrontCodedDictionary();
+    ~FrontCodedDictionary() = default;
+
+    void insert(const std::string& word);
+    void build();
+
+    bool search(const std::string& word) const;
+    bool startsWith(const std::string& prefix) const;
+
+    // Ordered scans, see range_scan.h. A scan decodes forward from the
+    // head of the block lo falls in.
+    using KeyCallback = ScanCallback;
+    void rangeScan(const std::string& lo, const std::string& hi, const KeyCallback& onKey) const;
+
+    // Every key starting with prefix, in lexicographic order
+    void prefixScan(const std::string& prefix, const KeyCallback& onKey) const;
+
+    std::string lowerBound(const std::string& key) const { return lowerBoundByScan(*this, key); }
+
+    size_t getMemoryUsage() const;
+    size_t getNodeCount() const { return blockOffsets.size(); }
+    size_t getWordCount() const { return wordCount; }
+    TrieStats stats() const;
+
+    void clear();
+    std::vector<std::string> getAllWords() const;
+
+private:
+    std::string_view blockHead(size_t block) const;
+    size_t findBlock(std::string_view key) const;
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef FROZEN_TRIE_H
+#define FROZEN_TRIE_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "dawg.h"
+#include "double_array_trie.h"
+#include "flat_trie.h"
+#include "trie_stats.h"
+
+// The read-only copies the standard and compressed tries can be turned into
+struct ToDoubleArray {
+    template<typename SourceType>
+    static auto from(const SourceType& source) { return source.freeze(); }
+};
+
+struct ToFlatLayout {
+    template<typename SourceType>
+    static auto from(const SourceType& source) { return source.relayout(); }
+};
+
+// A range scan hands the keys over in the sorted order the DAWG needs
+template<typename Alphabet>
+struct ToDawg {
+    template<typename SourceType>
+    static BasicDawg<Alphabet> from(const SourceType& source) {
+        BasicDawg<Alphabet> dawg;
+        source.rangeScan("", "", [&dawg](const std::string& key) {
+            dawg.insert(key);
+            return true;
+        });
+        dawg.build();
+        return dawg;
+    }
+};
+
+// Ingest into a pointer trie, serve from a read-only copy. Keys go into
+// the staging trie until build(), which converts it and drops it.
+// Queries are answered by the copy only, so keys inserted after build()
+// stay invisible until the next one, which rebuilds the copy from the
+// frozen keys plus the new ones.
+template<typename SourceType, typename Conversion = ToDoubleArray>
+class FrozenTrie {
+public:
+    using FrozenType = decltype(Conversion::from(std::declval<const SourceType&>()));
+
+private:
+    SourceType staging;
+    FrozenType frozen;
+
+public:
+    FrozenTrie() = default;
+
+    void insert(const std::string& word) { staging.insert(word); }
+    void build();
+
+    bool search(const std::string& word) const { return frozen.search(word); }
+    bool startsWith(const std::string& prefix) const { return frozen.startsWith(prefix); }
+
+    // Only for copies that answer these themselves
+    template<typename T = FrozenType>
+    auto fuzzySearch(const std::string& query, int maxDistance) const
+        -> decltype(std::declval<const T&>().fuzzySearch(query, maxDistance)) {
+        return frozen.fuzzySearch(query, maxDistance);
+    }
+    template<typename T = FrozenType>
+    auto matchPattern(const std::string& pattern) const
+        -> decltype(std::declval<const T&>().matchPattern(pattern)) {
+        return frozen.matchPattern(pattern);
+    }
+    template<typename OnMatch, typename T = FrozenType>
+    auto commonPrefixSearch(std::string_view input, OnMatch&& onMatch) const
+        -> decltype(std::declval<const T&>().commonPrefixSearch(input, onMatch)) {
+        frozen.commonPrefixSearch(input, std::forward<OnMatch>(onMatch));
+    }
+
+    size_t longestPrefixMatch(std::string_view input) const { return frozen.longestPrefixMatch(input); }
+
+    using KeyCallback = typename FrozenType::KeyCallback;
+    void rangeScan(const std::string& lo, const std::string& hi, const KeyCallback& onKey) const;
+    std::string lowerBound(const std::string& key) const { return frozen.lowerBound(key); }
+
+    const FrozenType& getFrozen() const { return frozen; }
+
+    size_t getMemoryUsage() const { return staging.getMemoryUsage() + frozen.getMemoryUsage(); }
+    size_t getNodeCount() const { return frozen.getNodeCount(); }
+    size_t getWordCount() const { return frozen.getWordCount(); }
+    TrieStats stats() const;
+
+    void clear();
+};
+
+#endif
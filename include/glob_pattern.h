@@ -0,0 +1,53 @@
+#ifndef GLOB_PATTERN_H
+#define GLOB_PATTERN_H
+
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Wildcard pattern compiled to a small NFA for trie traversal.
+//   ?        any single character
+//   *        any run of characters (including none)
+//   [abc]    one of the listed characters, ranges like [a-z] allowed
+//   [^abc]   (or [!abc]) any character not listed
+//   \x       the character x literally
+// The trie walk keeps one set of NFA positions per depth and drops a
+// subtree as soon as its set becomes empty.
+class GlobPattern {
+private:
+    struct Token {
+        enum Kind { LITERAL, ANY, STAR, CLASS } kind;
+        char literal;
+        std::bitset<256> members;  // for CLASS
+    };
+
+    std::vector<Token> tokens;
+    size_t words;  // uint64_t words per state set
+
+    void addClosure(uint64_t* states) const;
+
+public:
+    explicit GlobPattern(const std::string& pattern);
+
+    // size of one state set, in uint64_t words
+    size_t stateWords() const { return words; }
+
+    // State set before any character has been read
+    void start(uint64_t* states) const;
+
+    // Advances every position over c. Returns false if nothing survives.
+    bool step(const uint64_t* prev, uint64_t* next, char c) const;
+
+    bool isMatch(const uint64_t* states) const;
+
+    static constexpr int ANY_CHAR = -1;
+    static constexpr int NO_CHAR = -2;
+
+    // If the only way forward from these states is one literal character,
+    // returns it (as unsigned char) so the walk can follow a single child.
+    // ANY_CHAR if several characters may match, NO_CHAR if none can.
+    int forcedChar(const uint64_t* states) const;
+};
+
+#endif
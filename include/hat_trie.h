@@ -0,0 +1,91 @@
+#ifndef HAT_TRIE_H
+#define HAT_TRIE_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <vector>
+#include "alphabet.h"
+#include "child_table.h"
+#include "packed_strings.h"
+#include "range_scan.h"
+#include "trie_stats.h"
+
+// HAT-trie (Askitis & Sinha 2007) - a burst trie whose leaf containers
+// are array hash tables. Each slot of a container is one contiguous
+// buffer of length-prefixed suffixes, so a lookup is a hash, one slot
+// fetch and a short linear scan, with no node per key to chase. The
+// table doubles when slots average more than MAX_LOAD keys, and the whole
+// container bursts into a trie node once it holds BURST_THRESHOLD keys.
+// Containers are unordered: ordered scans sort the suffixes of each
+// container they pass through.
+template<typename Alphabet>
+class BasicHatTrie {
+private:
+    static constexpr uint32_t BURST_THRESHOLD = 4096;
+    static constexpr uint32_t MAX_LOAD = 8;
+    static constexpr size_t INITIAL_SLOTS = 8;
+
+    struct TrieNode {
+        ChildTable<TrieNode, Alphabet::size> children;
+        std::vector<std::string> slots;  // array hash table, see packed_strings.h
+        uint32_t keyCount;               // suffixes in slots
+        bool isContainer;                // false once burst
+        bool isEndOfWord;                // the key ending right here, never hashed
+
+        explicit TrieNode(bool container) : keyCount(0), isContainer(container), isEndOfWord(false) {}
+    };
+
+    std::unique_ptr<TrieNode> root;
+    size_t wordCount;
+    size_t nodeCount;
+    size_t memoryBytes;  // nodes, child arrays, slot arrays and slot buffers
+
+    StatCounter bursts;
+    mutable StatCounter lookups;
+    mutable StatCounter nodesVisited;
+
+public:
+    BasicHatTrie();
+    ~BasicHatTrie() = default;
+
+    void insert(const std::string& word);
+    bool search(const std::string& word) const;
+    bool startsWith(const std::string& prefix) const;
+    bool remove(const std::string& word);
+
+    // Ordered scans, see range_scan.h. Containers are hashed, so each one
+    // the scan reaches is collected and sorted first.
+    using KeyCallback = ScanCallback;
+    void rangeScan(const std::string& lo, const std::string& hi, const KeyCallback& onKey) const;
+
+    // Every key starting with prefix, in lexicographic order
+    void prefixScan(const std::string& prefix, const KeyCallback& onKey) const;
+
+    std::string lowerBound(const std::string& key) const { return lowerBoundByScan(*this, key); }
+
+    size_t getMemoryUsage() const { return memoryBytes; }
+    size_t getNodeCount() const { return nodeCount; }
+    size_t getWordCount() const { return wordCount; }
+    TrieStats stats() const;
+
+    void clear();
+    std::vector<std::string> getAllWords() const;
+
+private:
+    const TrieNode* descend(const std::string& key, size_t& depth) const;
+    TrieNode* addChild(TrieNode* node, int code);
+    bool addSuffix(TrieNode* node, std::string_view suffix);
+    void rehash(TrieNode* node, size_t slotCount);
+    void burst(TrieNode* node);
+    bool rangeScanHelper(const TrieNode* node, bool tight, const std::string& lo, const std::string& hi,
+                         std::string& word, const KeyCallback& onKey) const;
+    static size_t containerBytes(const TrieNode* node);
+    static size_t slotIndex(const TrieNode* node, std::string_view suffix);
+    static size_t findInSlot(const std::string& slot, std::string_view suffix);
+};
+
+using HatTrie = BasicHatTrie<ByteAlphabet>;
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef HUGE_PAGE_ALLOCATOR_H
+#define HUGE_PAGE_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// How large trie arrays get their memory. Random transitions over arrays
+// of hundreds of MB miss the dTLB on nearly every step with 4 KB pages;
+// backing them with 2 MB transparent huge pages cuts the TLB footprint by
+// 512x. The policy is read at allocation time, so it can be switched
+// between builds (the benchmark does this to compare both settings).
+struct PagePolicy {
+    bool hugePages = true;   // madvise(MADV_HUGEPAGE) on large blocks
+    bool populate = false;   // fault every page in when the block is allocated
+
+    static PagePolicy& current() {
+        static PagePolicy policy;
+        return policy;
+    }
+};
+
+// Switches the policy for its own lifetime and restores the previous one,
+// also when what runs under it throws
+class ScopedPagePolicy {
+private:
+    PagePolicy saved;
+
+public:
+    explicit ScopedPagePolicy(const PagePolicy& policy) : saved(PagePolicy::current()) {
+        PagePolicy::current() = policy;
+    }
+    ~ScopedPagePolicy() { PagePolicy::current() = saved; }
+    ScopedPagePolicy(const ScopedPagePolicy&) = delete;
+    ScopedPagePolicy& operator=(const ScopedPagePolicy&) = delete;
+};
+
+// Allocator for std::vector and friends. Blocks of at least one huge page
+// come straight from mmap, aligned to 2 MB so every page of the block can
+// be a huge page; smaller ones use operator new. The size threshold alone
+// decides which path a block took, so deallocate never needs to know the
+// policy that was active when it was allocated.
+template<typename T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    static constexpr size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+
+    HugePageAllocator() = default;
+    template<typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+#ifdef __linux__
+        if (bytes >= HUGE_PAGE_SIZE) {
+            return static_cast<T*>(mapAligned(roundUp(bytes)));
+        }
+#endif
+        return static_cast<T*>(::operator new(bytes));
+    }
+
+    void deallocate(T* p, size_t n) {
+        size_t bytes = n * sizeof(T);
+#ifdef __linux__
+        if (bytes >= HUGE_PAGE_SIZE) {
+            munmap(p, roundUp(bytes));
+            return;
+        }
+#endif
+        ::operator delete(p);
+    }
+
+private:
+    static size_t roundUp(size_t bytes) {
+        return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    }
+
+#ifdef __linux__
+    // Over-maps by one huge page and trims both ends to reach alignment
+    static void* mapAligned(size_t bytes) {
+        size_t span = bytes + HUGE_PAGE_SIZE;
+        void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+
+        char* start = static_cast<char*>(raw);
+        char* aligned = reinterpret_cast<char*>(
+            (reinterpret_cast<uintptr_t>(start) + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1));
+        if (aligned > start) {
+            munmap(start, aligned - start);
+        }
+        size_t tail = (start + span) - (aligned + bytes);
+        if (tail > 0) {
+            munmap(aligned + bytes, tail);
+        }
+
+        const PagePolicy& policy = PagePolicy::current();
+#ifdef MADV_HUGEPAGE
+        madvise(aligned, bytes, policy.hugePages ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+#endif
+        // MAP_POPULATE would fault the range in before the madvise above
+        // and leave it on 4 KB pages, so pre-faulting happens afterwards
+        if (policy.populate) {
+#ifdef MADV_POPULATE_WRITE
+            if (madvise(aligned, bytes, MADV_POPULATE_WRITE) == 0) {
+                return aligned;
+            }
+#endif
+            for (size_t offset = 0; offset < bytes; offset += 4096) {
+                aligned[offset] = 0;
+            }
+        }
+
+        return aligned;
+    }
+#endif
+};
+
+template<typename T, typename U>
+bool operator==(const HugePageAllocator<T>&, const HugePageAllocator<U>&) { return true; }
+
+template<typename T, typename U>
+bool operator!=(const HugePageAllocator<T>&, const HugePageAllocator<U>&) { return false; }
+
+#endif
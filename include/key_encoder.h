@@ -0,0 +1,68 @@
+#ifndef KEY_ENCODER_H
+#define KEY_ENCODER_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Order-preserving key compression in the style of HOPE (Zhang et al.,
+// SIGMOD 2020). Training picks frequent byte n-grams from a key sample
+// and cuts the key space into intervals: every interval holds the strings
+// that share one symbol (an n-gram or a single byte) as a prefix. A key is
+// encoded by repeatedly finding the interval its remaining suffix falls
+// in, emitting that interval's code and skipping the symbol.
+//
+// Codes are handed out in interval order and are prefix-free, so
+// a < b  <=>  encode(a) < encode(b)  and encoded keys can go into any
+// byte-alphabet trie with lookups, lowerBound and range scans intact.
+// Codes are one or two whole bytes: the intervals used most in the
+// sample get a first byte to themselves, the rest share first bytes in
+// blocks of 256.
+class KeyEncoder {
+private:
+    struct Interval {
+        std::string lower;      // smallest string in the interval
+        uint16_t symbolLength;  // the symbol is lower.substr(0, symbolLength)
+        uint16_t code;          // first byte in the high half if codeLength is 2
+        uint8_t codeLength;
+    };
+
+    // One entry per first code byte
+    struct DecodeEntry {
+        uint32_t interval;  // the interval, or the first one of a two-byte block
+        bool twoByte;
+    };
+
+    std::vector<Interval> intervals;        // sorted by lower bound
+    std::array<uint32_t, 257> firstInterval;  // intervals whose bound starts with byte c
+    std::array<DecodeEntry, 256> decodeTable;
+
+public:
+    static constexpr size_t MAX_SYMBOLS = 16384;
+
+    KeyEncoder() : firstInterval(), decodeTable() {}
+
+    // Builds the dictionary from a sample of keys. symbols caps the number
+    // of multi-byte n-grams (at most MAX_SYMBOLS), maxGram their length.
+    void train(const std::vector<std::string>& sample, size_t symbols = 4096, size_t maxGram = 8);
+
+    // Until train() runs, encode and decode return the key unchanged
+    bool isTrained() const { return !intervals.empty(); }
+
+    std::string encode(std::string_view key) const;
+    void encode(std::string_view key, std::string& out) const;  // appends to out
+    std::string decode(std::string_view code) const;
+
+    size_t getIntervalCount() const { return intervals.size(); }
+    size_t getMemoryUsage() const;
+
+    void clear();
+
+private:
+    const Interval& locate(std::string_view rest) const;
+    void assignCodes(const std::vector<size_t>& uses);
+};
+
+#endif
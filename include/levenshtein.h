@@ -0,0 +1,44 @@
+#ifndef LEVENSHTEIN_H
+#define LEVENSHTEIN_H
+
+#include <string>
+#include <vector>
+
+// A dictionary word within edit distance of a fuzzy query
+struct FuzzyMatch {
+    std::string word;
+    int distance;
+};
+
+// Levenshtein automaton simulated with incremental DP rows. While a trie
+// is walked, each character appended to the candidate derives a new row
+// from its parent's row, so shared prefixes are computed once. Only the
+// diagonal band |i - j| <= maxDistance is filled; cells outside it can
+// never come back under the bound.
+class LevenshteinAutomaton {
+private:
+    std::string query;
+    int maxDistance;
+
+public:
+    LevenshteinAutomaton(const std::string& query, int maxDistance);
+
+    size_t rowSize() const { return query.size() + 1; }
+    int getMaxDistance() const { return maxDistance; }
+
+    // Row for the empty candidate
+    void start(int* row) const;
+
+    // Computes the row after appending c to a candidate of length depth - 1.
+    // Returns the smallest value in the new row.
+    int step(const int* prev, int* next, char c, size_t depth) const;
+
+    // Distance if the candidate ends here (valid only when <= maxDistance)
+    int distance(const int* row) const { return row[query.size()]; }
+    bool isMatch(const int* row) const { return row[query.size()] <= maxDistance; }
+
+    // No extension of the candidate can get back under the bound
+    bool isDead(int rowMin) const { return rowMin > maxDistance; }
+};
+
+#endif
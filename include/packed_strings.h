@@ -0,0 +1,69 @@
+#ifndef PACKED_STRINGS_H
+#define PACKED_STRINGS_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Strings packed back to back in one buffer, each behind a LEB128
+// length. Leaf containers use this so that keys cost their own bytes
+// plus one (for lengths under 128) instead of an allocation apiece.
+
+// Reads the LEB128 number at pos into value and returns the position after it
+inline size_t readVarint(const std::string& buffer, size_t pos, size_t& value) {
+    value = 0;
+    for (int shift = 0;; shift += 7) {
+        unsigned char byte = static_cast<unsigned char>(buffer[pos++]);
+        value |= static_cast<size_t>(byte & 0x7f) << shift;
+        if (byte < 0x80) {
+            return pos;
+        }
+    }
+}
+
+inline void appendVarint(std::string& buffer, size_t value) {
+    do {
+        unsigned char byte = value & 0x7f;
+        value >>= 7;
+        buffer.push_back(static_cast<char>(value ? byte | 0x80 : byte));
+    } while (value);
+}
+
+// Reads the string at pos into entry and returns the position of the next one
+inline size_t readPacked(const std::string& buffer, size_t pos, std::string_view& entry) {
+    size_t length;
+    pos = readVarint(buffer, pos, length);
+    entry = std::string_view(buffer.data() + pos, length);
+    return pos + length;
+}
+
+// Inserts entry so that it starts at pos (buffer.size() appends)
+inline void insertPacked(std::string& buffer, size_t pos, std::string_view entry) {
+    char header[10];
+    size_t headerLength = 0;
+    size_t length = entry.size();
+    do {
+        unsigned char byte = length & 0x7f;
+        length >>= 7;
+        header[headerLength++] = static_cast<char>(length ? byte | 0x80 : byte);
+    } while (length);
+
+    buffer.insert(pos, entry.size() + headerLength, '\0');
+    buffer.replace(pos, headerLength, header, headerLength);
+    buffer.replace(pos + headerLength, entry.size(), entry.data(), entry.size());
+}
+
+// Removes the string that starts at pos
+inline void erasePacked(std::string& buffer, size_t pos) {
+    std::string_view entry;
+    size_t next = readPacked(buffer, pos, entry);
+    buffer.erase(pos, next - pos);
+}
+
+// Heap bytes held by a buffer; short ones live inside the string object
+inline size_t packedHeapBytes(const std::string& buffer) {
+    static const size_t inlineCapacity = std::string().capacity();
+    return buffer.capacity() > inlineCapacity ? buffer.capacity() + 1 : 0;
+}
+
+#endif
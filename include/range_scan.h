@@ -0,0 +1,26 @@
+#ifndef RANGE_SCAN_H
+#define RANGE_SCAN_H
+
+#include <functional>
+#include <string>
+
+// The ordered structures share one range interface.
+// rangeScan(lo, hi, onKey) calls onKey for every key in [lo, hi), in
+// lexicographic order (alphabet code order for the tries), and stops at
+// hi or as soon as onKey returns false. An empty hi means no upper
+// bound. lowerBound(key) is the smallest key >= key, or the empty string
+// if there is none.
+using ScanCallback = std::function<bool(const std::string& key)>;
+
+// lowerBound as the first key of a scan starting at key
+template<typename OrderedType>
+std::string lowerBoundByScan(const OrderedType& keys, const std::string& key) {
+    std::string found;
+    keys.rangeScan(key, "", [&found](const std::string& k) {
+        found = k;
+        return false;
+    });
+    return found;
+}
+
+#endif
@@ -1,46 +1,133 @@
 #ifndef STANDARD_TRIE_H
 #define STANDARD_TRIE_H
 
+#include <functional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <memory>
 #include <vector>
+#include "alphabet.h"
+#include "levenshtein.h"
+#include "glob_pattern.h"
+#include "child_table.h"
+#include "double_array_trie.h"
+#include "flat_trie.h"
+#include "range_scan.h"
+#include "trie_stats.h"
 
-// Standard Trie implementation - basic version with map of children
-// Each node stores a map to its children. Simple to implement but uses more memory.
-class StandardTrie {
+// Standard Trie implementation - basic version with a table of children
+// Each node stores its children indexed by alphabet code. Simple to implement but uses more memory.
+template<typename Alphabet>
+class BasicStandardTrie {
 private:
     struct TrieNode {
-        std::unordered_map<char, std::unique_ptr<TrieNode>> children;
+        ChildTable<TrieNode, Alphabet::size> children;
+        uint32_t wordsBelow;  // keys ending at or below this node
         bool isEndOfWord;
-        
-        TrieNode() : isEndOfWord(false) {}
+
+        TrieNode() : wordsBelow(0), isEndOfWord(false) {}
     };
-    
+
     std::unique_ptr<TrieNode> root;
     size_t wordCount;
     size_t nodeCount;
-    
+    size_t memoryBytes;  // nodes plus their child arrays, kept current by insert
+
+    mutable StatCounter lookups;
+    mutable StatCounter nodesVisited;
+
 public:
-    StandardTrie();
-    ~StandardTrie() = default;
-    
+    BasicStandardTrie();
+    ~BasicStandardTrie() = default;
+
     void insert(const std::string& word);
     bool search(const std::string& word) const;
     bool startsWith(const std::string& prefix) const;
     bool remove(const std::string& word);
-    
-    size_t getMemoryUsage() const;
+
+    // All words within maxDistance edits (Levenshtein) of the query, found by
+    // walking the trie in lockstep with the automaton and pruning dead branches
+    std::vector<FuzzyMatch> fuzzySearch(const std::string& query, int maxDistance) const;
+
+    // Words matching a wildcard pattern (?, *, [a-z], [^...]), see GlobPattern.
+    // Only the branches the pattern can still match are explored.
+    std::vector<std::string> matchPattern(const std::string& pattern) const;
+
+    // Keys that are prefixes of input, found in one walk from the root.
+    // onMatch(size_t length) is called for each one, shortest first.
+    template<typename OnMatch>
+    void commonPrefixSearch(std::string_view input, OnMatch&& onMatch) const;
+
+    // Length of the longest key that is a prefix of input, 0 if there is none
+    size_t longestPrefixMatch(std::string_view input) const;
+
+    // Ordered scans, see range_scan.h. Seeking to lo costs one child
+    // lookup per character of lo.
+    using KeyCallback = ScanCallback;
+    void rangeScan(const std::string& lo, const std::string& hi, const KeyCallback& onKey) const;
+
+    std::string lowerBound(const std::string& key) const { return lowerBoundByScan(*this, key); }
+
+    // Order statistics from the per-node key counts. countPrefix is one
+    // walk down the prefix; rank and select also add up the counts of
+    // the siblings they pass.
+    size_t countPrefix(const std::string& prefix) const;
+    size_t rank(const std::string& key) const;       // keys < key
+    std::string select(size_t index) const;          // index-th key in order, empty if out of range
+
+    size_t getMemoryUsage() const { return memoryBytes; }
     size_t getNodeCount() const { return nodeCount; }
     size_t getWordCount() const { return wordCount; }
-    
+    TrieStats stats() const;
+
+    // Read-only copy as a double array, built in one breadth-first walk.
+    // Every state's child block is placed once, so there is none of the
+    // relocation of inserting the keys one by one, and the arrays come
+    // out trimmed to the last used slot. The empty key is dropped, since
+    // a double array can't hold it.
+    BasicDoubleArrayTrie<Alphabet> freeze() const;
+
+    // Read-only copy in one contiguous buffer, laid out for lookups
+    // (see BasicFlatTrie)
+    BasicFlatTrie<Alphabet> relayout() const;
+
     void clear();
     std::vector<std::string> getAllWords() const;
-    
+
 private:
-    void getAllWordsHelper(const TrieNode* node, std::string currentWord, 
+    const TrieNode* findNode(const std::string& key) const;
+    void addToCounts(const std::string& key, int delta);
+    void getAllWordsHelper(const TrieNode* node, std::string currentWord,
                           std::vector<std::string>& words) const;
-    size_t calculateMemoryUsage(const TrieNode* node) const;
+    void fuzzySearchHelper(const TrieNode* node, const LevenshteinAutomaton& automaton, std::vector<int>& rows,
+                           std::string& word, std::vector<FuzzyMatch>& matches) const;
+    void matchPatternHelper(const TrieNode* node, const GlobPattern& glob, std::vector<uint64_t>& states,
+                            std::string& word, std::vector<std::string>& matches) const;
+    bool rangeScanHelper(const TrieNode* node, bool tight, const std::string& lo, const std::string& hi,
+                         std::string& word, const KeyCallback& onKey) const;
 };
 
+template<typename Alphabet>
+template<typename OnMatch>
+void BasicStandardTrie<Alphabet>::commonPrefixSearch(std::string_view input, OnMatch&& onMatch) const {
+    const TrieNode* current = root.get();
+
+    // the empty key is a prefix of every input
+    if (current->isEndOfWord) {
+        onMatch(0);
+    }
+
+    for (size_t i = 0; i < input.size(); i++) {
+        current = current->children.find(Alphabet::toCode(input[i]));
+        if (!current) {
+            return;
+        }
+        if (current->isEndOfWord) {
+            onMatch(i + 1);
+        }
+    }
+}
+
+using StandardTrie = BasicStandardTrie<ByteAlphabet>;
+
 #endif
@@ -0,0 +1,70 @@
+#ifndef TRIE_STATS_H
+#define TRIE_STATS_H
+
+#include <atomic>
+#include <cstddef>
+
+// Event counters compile to nothing unless the build sets TRIE_STATS=1
+// (make STATS=1). They cost a load and a store per lookup, which would
+// show up in every benchmark timing.
+#ifndef TRIE_STATS
+#define TRIE_STATS 0
+#endif
+
+// Snapshot returned by stats() on every trie. Memory, node and word
+// counts are kept up to date by the mutating operations themselves, so a
+// snapshot is O(1) and safe to poll. Fields a structure doesn't have
+// (splits on a double array, probes on a pointer trie) stay 0.
+struct TrieStats {
+    size_t memoryBytes = 0;
+    size_t nodes = 0;
+    size_t words = 0;
+
+    // the rest are 0 when built with TRIE_STATS=0
+    size_t splits = 0;          // CompressedTrie edge splits
+    size_t bursts = 0;          // leaf containers turned into trie nodes
+    size_t relocations = 0;     // DoubleArrayTrie child blocks moved to a new base
+    size_t findBaseCalls = 0;
+    size_t findBaseProbes = 0;  // free-list slots examined by findBase
+    size_t lookups = 0;         // search/startsWith walks
+    size_t nodesVisited = 0;    // nodes entered by those lookups
+
+    double probesPerFindBase() const {
+        return findBaseCalls > 0 ? static_cast<double>(findBaseProbes) / findBaseCalls : 0.0;
+    }
+    double nodesPerLookup() const {
+        return lookups > 0 ? static_cast<double>(nodesVisited) / lookups : 0.0;
+    }
+};
+
+// One event counter. Lookups are const and may run on several reader
+// threads, so the value is atomic, but updated with a relaxed load and
+// store instead of a locked add: an increment can get lost under
+// contention, which telemetry tolerates, and readers never serialize.
+class StatCounter {
+#if TRIE_STATS
+private:
+    std::atomic<size_t> value{0};
+
+public:
+    StatCounter() = default;
+    StatCounter(const StatCounter& other) : value(other.get()) {}
+    StatCounter& operator=(const StatCounter& other) {
+        value.store(other.get(), std::memory_order_relaxed);
+        return *this;
+    }
+
+    void add(size_t n) {
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    size_t get() const { return value.load(std::memory_order_relaxed); }
+    void reset() { value.store(0, std::memory_order_relaxed); }
+#else
+public:
+    void add(size_t) {}
+    size_t get() const { return 0; }
+    void reset() {}
+#endif
+};
+
+#endif
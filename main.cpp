@@ -1,96 +1,242 @@
 #include <iostream>
+#include <algorithm>
+#include <cstdlib>
 #include <vector>
 #include <iomanip>
 #include <fstream>
+#include <set>
+#include <sstream>
 #include "standard_trie.h"
 #include "compressed_trie.h"
 #include "double_array_trie.h"
 #include "benchmark.h"
 
-// Helper to write results to CSV for making graphs later
-void saveResultsToCSV(const std::vector<BenchmarkResult>& results, const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Could not open " << filename << " for writing\n";
-        return;
-    }
-    
-    // Write header
-    file << "TrieType,DatasetSize,MemoryKB,InsertTimeMS,SearchTimeMS,BytesPerWord,AvgInsertUS,AvgSearchUS\n";
-    
-    // Write data
-    for (const auto& result : results) {
-        file << result.trieType << ","
-             << result.datasetSize << ","
-             << std::fixed << std::setprecision(2)
-             << result.memoryUsage / 1024.0 << ","
-             << result.insertionTime / 1000.0 << ","
-             << result.searchTime / 1000.0 << ","
-             << result.memoryPerWord << ","
-             << result.avgInsertTime << ","
-             << result.avgSearchTime << "\n";
-    }
-    
-    file.close();
-    std::cout << "Results saved to " << filename << "\n";
+// Command-line options for the benchmark driver
+struct Options {
+    std::vector<std::string> tries;      // variant names, empty = all registered
+    std::vector<size_t> sizes;           // dataset sizes, empty = defaults
+    std::string keys = "random";         // "random" or a file with one key per line
+    size_t minLen = 5;
+    size_t maxLen = 15;
+    std::set<std::string> workloads = {"insert", "search", "miss"};
+    size_t queries = 1000;
+    std::string csvFile = "benchmark_results.csv";
+    std::string jsonFile;                // empty = off, "-" = stdout
+    bool seeded = false;
+    unsigned seed = 0;
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n\n"
+              << "  --trie=NAME[,NAME...]     variants to run (default: all)\n"
+              << "  --sizes=N[,N...]          dataset sizes, e.g. 1e6,1e7,1e8\n"
+              << "                            (default: 1000,10000,50000 random / whole file)\n"
+              << "  --keys=random|FILE        random keys or one key per line from FILE\n"
+              << "  --minlen=N --maxlen=N     random key length range (default 5-15)\n"
+              << "  --workload=W[,W...]       workloads after insertion, or 'all'\n"
+              << "  --queries=N               queries per search workload (default 1000)\n"
+              << "  --seed=N                  seed for key generation and sampling\n"
+              << "  --csv=FILE                CSV output (default benchmark_results.csv, '' = off)\n"
+              << "  --json=FILE               JSON lines output, '-' for stdout\n"
+              << "  --help                    show this message\n\n";
+
+    std::cout << "Variants:";
+    for (const auto& variant : Benchmark::variants()) {
+        std::cout << " " << variant.name;
+    }
+    std::cout << "\nWorkloads:";
+    for (const auto& name : Benchmark::workloadNames()) {
+        std::cout << " " << name;
+    }
+    std::cout << "\n";
 }
 
-void runComparison(Benchmark& bench, const std::string& datasetName, std::vector<BenchmarkResult>& allResults) {
-    std::cout << "\nTesting with: " << datasetName << "\n";
-    std::cout << "Dataset size: " << bench.getDatasetSize() << " words\n";
-    std::cout << "--\n";
-    
-    // Run benchmarks for all three variants
-    auto stdResult = bench.run<StandardTrie>("Standard Trie");
-    allResults.push_back(stdResult);
-    
-    auto compResult = bench.run<CompressedTrie>("Compressed Trie");
-    allResults.push_back(compResult);
-    
-    auto daResult = bench.run<DoubleArrayTrie>("Double-Array Trie");
-    allResults.push_back(daResult);
-    
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// Accepts plain integers and scientific notation like 1e7
+bool parseCount(const std::string& text, size_t& value) {
+    try {
+        size_t used = 0;
+        double parsed = std::stod(text, &used);
+        if (used != text.size() || parsed < 0) {
+            return false;
+        }
+        value = static_cast<size_t>(parsed);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool parseOptions(int argc, char* argv[], Options& opts) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+        if (key == "--help" || key == "-h") {
+            printUsage(argv[0]);
+            std::exit(0);
+        } else if (key == "--trie") {
+            opts.tries = splitList(value);
+            for (const auto& name : opts.tries) {
+                if (!Benchmark::findVariant(name)) {
+                    std::cerr << "Unknown trie variant: " << name << "\n";
+                    return false;
+                }
+            }
+        } else if (key == "--sizes") {
+            opts.sizes.clear();
+            for (const auto& item : splitList(value)) {
+                size_t size;
+                if (!parseCount(item, size) || size == 0) {
+                    std::cerr << "Bad dataset size: " << item << "\n";
+                    return false;
+                }
+                opts.sizes.push_back(size);
+            }
+        } else if (key == "--keys") {
+            opts.keys = value;
+        } else if (key == "--minlen" || key == "--maxlen" || key == "--queries" || key == "--seed") {
+            size_t number;
+            if (!parseCount(value, number)) {
+                std::cerr << "Bad value for " << key << ": " << value << "\n";
+                return false;
+            }
+            if (key == "--minlen") opts.minLen = number;
+            else if (key == "--maxlen") opts.maxLen = number;
+            else if (key == "--queries") opts.queries = number;
+            else { opts.seed = static_cast<unsigned>(number); opts.seeded = true; }
+        } else if (key == "--workload") {
+            std::vector<std::string> known = Benchmark::workloadNames();
+            opts.workloads.clear();
+            for (const auto& name : splitList(value)) {
+                if (name == "all") {
+                    opts.workloads.insert(known.begin(), known.end());
+                } else if (std::find(known.begin(), known.end(), name) != known.end()) {
+                    opts.workloads.insert(name);
+                } else {
+                    std::cerr << "Unknown workload: " << name << "\n";
+                    return false;
+                }
+            }
+        } else if (key == "--csv") {
+            opts.csvFile = value;
+        } else if (key == "--json") {
+            opts.jsonFile = value;
+        } else {
+            std::cerr << "Unknown option: " << arg << " (see --help)\n";
+            return false;
+        }
+    }
+
+    if (opts.minLen == 0 || opts.minLen > opts.maxLen) {
+        std::cerr << "Need 0 < --minlen <= --maxlen\n";
+        return false;
+    }
+
+    return true;
+}
+
+// Writes each result as soon as it is available, so long runs can be
+// followed (and survive being interrupted)
+class ResultWriter {
+private:
+    std::ofstream csv;
+    std::ofstream jsonFile;
+    std::ostream* json = nullptr;
+
+public:
+    bool open(const Options& opts) {
+        if (!opts.csvFile.empty()) {
+            csv.open(opts.csvFile);
+            if (!csv.is_open()) {
+                std::cerr << "Could not open " << opts.csvFile << " for writing\n";
+                return false;
+            }
+            csv << BenchmarkResult::csvHeader() << "\n";
+        }
+
+        if (opts.jsonFile == "-") {
+            json = &std::cout;
+        } else if (!opts.jsonFile.empty()) {
+            jsonFile.open(opts.jsonFile);
+            if (!jsonFile.is_open()) {
+                std::cerr << "Could not open " << opts.jsonFile << " for writing\n";
+                return false;
+            }
+            json = &jsonFile;
+        }
+        return true;
+    }
+
+    void write(const BenchmarkResult& result) {
+        if (csv.is_open()) {
+            csv << result.toCsv() << std::endl;
+        }
+        if (json) {
+            *json << result.toJson() << std::endl;
+        }
+    }
+};
+
+void runComparison(Benchmark& bench, const std::string& datasetName,
+                   const std::vector<const TrieVariant*>& variants,
+                   ResultWriter& writer, std::ostream& log) {
+    log << "\nTesting with: " << datasetName << "\n";
+    log << "Dataset size: " << bench.getDatasetSize() << " words\n";
+    log << "--\n";
+
     // Print comparison
-    std::cout << "\nResults:\n";
-    std::cout << std::left << std::setw(20) << "Implementation"
-              << std::setw(15) << "Memory (KB)"
-              << std::setw(15) << "Insert (ms)"
-              << std::setw(15) << "Search (ms)"
-              << std::setw(15) << "Bytes/Word\n";
-    std::cout << "--\n";
-    
-    std::cout << std::fixed << std::setprecision(2);
-    
-    std::cout << std::setw(20) << "Standard Trie"
-              << std::setw(15) << stdResult.memoryUsage / 1024.0
-              << std::setw(15) << stdResult.insertionTime / 1000.0
-              << std::setw(15) << stdResult.searchTime / 1000.0
-              << std::setw(15) << stdResult.memoryPerWord << "\n";
-    
-    std::cout << std::setw(20) << "Compressed Trie"
-              << std::setw(15) << compResult.memoryUsage / 1024.0
-              << std::setw(15) << compResult.insertionTime / 1000.0
-              << std::setw(15) << compResult.searchTime / 1000.0
-              << std::setw(15) << compResult.memoryPerWord << "\n";
-    
-    std::cout << std::setw(20) << "Double-Array Trie"
-              << std::setw(15) << daResult.memoryUsage / 1024.0
-              << std::setw(15) << daResult.insertionTime / 1000.0
-              << std::setw(15) << daResult.searchTime / 1000.0
-              << std::setw(15) << daResult.memoryPerWord << "\n";
+    size_t nameWidth = 25;
+    for (const TrieVariant* variant : variants) {
+        nameWidth = std::max(nameWidth, variant->displayName.size() + 2);
+    }
+
+    log << "\nResults:\n";
+    log << std::left << std::setw(nameWidth) << "Implementation"
+        << std::setw(15) << "Memory (KB)"
+        << std::setw(15) << "Insert (ms)"
+        << std::setw(15) << "Search (ms)"
+        << std::setw(15) << "Bytes/Word\n";
+    log << "--\n";
+
+    log << std::fixed << std::setprecision(2);
+
+    for (const TrieVariant* variant : variants) {
+        BenchmarkResult result = variant->run(bench);
+        writer.write(result);
+
+        log << std::setw(nameWidth) << result.trieType
+            << std::setw(15) << result.memoryUsage / 1024.0
+            << std::setw(15) << result.insertionTime / 1000.0
+            << std::setw(15) << result.searchTime / 1000.0
+            << std::setw(15) << result.memoryPerWord << std::endl;
+    }
 }
 
 void quickTest() {
     std::cout << "Quick test with a few words:\n";
     std::cout << "--\n";
-    
+
     std::vector<std::string> testWords = {"apple", "application", "apply", "banana", "band"};
-    
+
     StandardTrie trie;
     for (const auto& word : testWords) {
         trie.insert(word);
     }
-    
+
     std::cout << "Inserted 5 words\n";
     std::cout << "Search 'apple': " << (trie.search("apple") ? "found" : "not found") << "\n";
     std::cout << "Search 'app': " << (trie.search("app") ? "found" : "not found") << "\n";
@@ -99,49 +245,77 @@ void quickTest() {
 }
 
 int main(int argc, char* argv[]) {
-    (void)argc; (void)argv; // unused
-    
-    std::cout << "Trie Benchmark Program\n";
-    std::cout << "======================\n\n";
-    
-    quickTest();
-    std::cout << "\n";
-    
-    std::vector<BenchmarkResult> allResults;
-    
-    std::cout << "Running benchmarks...\n\n";
-    
-    // Small test
-    Benchmark bench1;
-    bench1.generateRandomStrings(1000, 5, 15);
-    runComparison(bench1, "1K Random Words", allResults);
-    
-    // Medium test
-    Benchmark bench2;
-    bench2.generateRandomStrings(10000, 5, 15);
-    runComparison(bench2, "10K Random Words", allResults);
-    
-    // Large test
-    Benchmark bench3;
-    bench3.generateRandomStrings(50000, 5, 15);
-    runComparison(bench3, "50K Random Words", allResults);
-    
-    // Check if dictionary exists
-    std::ifstream dictFile("dictionary.txt");
-    if (dictFile.good()) {
-        dictFile.close();
-        std::cout << "\nFound dictionary.txt, testing with real words...\n";
-        Benchmark dictBench;
-        dictBench.loadDictionary("dictionary.txt");
-        if (dictBench.getDatasetSize() > 0) {
-            runComparison(dictBench, "Real English Dictionary", allResults);
+    Options opts;
+    if (!parseOptions(argc, argv, opts)) {
+        return 1;
+    }
+
+    // Human-readable output moves to stderr when JSON goes to stdout
+    std::ostream& log = opts.jsonFile == "-" ? std::cerr : std::cout;
+
+    log << "Trie Benchmark Program\n";
+    log << "======================\n\n";
+
+    if (argc == 1) {
+        quickTest();
+        std::cout << "\n";
+    }
+
+    std::vector<const TrieVariant*> variants;
+    if (opts.tries.empty()) {
+        for (const auto& variant : Benchmark::variants()) {
+            variants.push_back(&variant);
+        }
+    } else {
+        for (const auto& name : opts.tries) {
+            variants.push_back(Benchmark::findVariant(name));
         }
     }
-    
-    // Save results
-    saveResultsToCSV(allResults, "benchmark_results.csv");
-    
-    std::cout << "\nDone. Check benchmark_results.csv for data.\n";
-    
+
+    bool randomKeys = opts.keys == "random";
+    std::vector<size_t> sizes = opts.sizes;
+    if (sizes.empty()) {
+        sizes = randomKeys ? std::vector<size_t>{1000, 10000, 50000} : std::vector<size_t>{0};
+    }
+
+    ResultWriter writer;
+    if (!writer.open(opts)) {
+        return 1;
+    }
+
+    log << "Running benchmarks...\n\n";
+
+    for (size_t size : sizes) {
+        Benchmark bench;
+        if (opts.seeded) {
+            bench.setSeed(opts.seed);
+        }
+        bench.setWorkloads(opts.workloads);
+        bench.setQueryCount(opts.queries);
+
+        std::string datasetName;
+        if (randomKeys) {
+            bench.generateRandomStrings(size, opts.minLen, opts.maxLen);
+            datasetName = std::to_string(size) + " Random Words";
+        } else {
+            bench.loadFromFile(opts.keys);
+            if (size > 0) {
+                bench.truncateDataset(size);
+            }
+            datasetName = opts.keys;
+        }
+
+        if (bench.getDatasetSize() == 0) {
+            std::cerr << "No keys to benchmark\n";
+            return 1;
+        }
+
+        runComparison(bench, datasetName, variants, writer, log);
+    }
+
+    if (!opts.csvFile.empty()) {
+        log << "\nDone. Check " << opts.csvFile << " for data.\n";
+    }
+
     return 0;
 }
@@ -0,0 +1,143 @@
+#include "aho_corasick.h"
+#include <queue>
+
+template<typename Alphabet>
+BasicAhoCorasick<Alphabet>::BasicAhoCorasick() : rootGoto(), built(false) {}
+
+template<typename Alphabet>
+void BasicAhoCorasick<Alphabet>::insert(const std::string& pattern) {
+    trie.insert(pattern);
+    built = false;
+}
+
+// Breadth-first over the trie so a state's failure target (always
+// shallower) is finished before the state itself
+template<typename Alphabet>
+void BasicAhoCorasick<Alphabet>::build() {
+    trie.compact();
+
+    size_t size = trie.getArraySize();
+    fail.assign(size, 0);
+    output.assign(size, EMPTY);
+    depth.assign(size, 0);
+
+    for (int code = 0; code < Alphabet::size; code++) {
+        int child = trie.getTransition(0, code);
+        rootGoto[code] = child == EMPTY ? 0 : child;
+    }
+
+    std::queue<int> pending;
+    pending.push(0);
+
+    while (!pending.empty()) {
+        int state = pending.front();
+        pending.pop();
+
+        for (int code = 0; code < Alphabet::size; code++) {
+            int child = trie.getTransition(state, code);
+            if (child == EMPTY) {
+                continue;
+            }
+
+            depth[child] = depth[state] + 1;
+
+            if (state != 0) {
+                int f = fail[state];
+                while (f != 0 && trie.getTransition(f, code) == EMPTY) {
+                    f = fail[f];
+                }
+                int target = trie.getTransition(f, code);
+                fail[child] = target == EMPTY ? 0 : target;
+            }
+
+            int f = fail[child];
+            output[child] = trie.base[f] < 0 ? f : output[f];
+
+            pending.push(child);
+        }
+    }
+
+    built = true;
+}
+
+// Reads base/check directly rather than through getTransition so the
+// per-byte loop stays inline; states are always in range after compact()
+template<typename Alphabet>
+int BasicAhoCorasick<Alphabet>::next(int state, int code) const {
+    if (code < 0) {
+        return 0;  // no pattern contains this character
+    }
+
+    const int* base = trie.base.data();
+    const int* check = trie.check.data();
+    int size = static_cast<int>(trie.check.size());
+
+    while (state != 0) {
+        int b = base[state];
+        int target = (b < 0 ? -b - 1 : b) + code;
+        if (target < size && check[target] == state) {
+            return target;
+        }
+        state = fail[state];
+    }
+
+    return rootGoto[code];
+}
+
+template<typename Alphabet>
+void BasicAhoCorasick<Alphabet>::scan(const std::string& text, const MatchCallback& onMatch) const {
+    StreamState stream;
+    scan(text.data(), text.size(), stream, onMatch);
+}
+
+template<typename Alphabet>
+void BasicAhoCorasick<Alphabet>::scan(const char* data, size_t length, StreamState& stream,
+                                      const MatchCallback& onMatch) const {
+    if (!built) return;
+
+    int state = stream.state;
+
+    for (size_t i = 0; i < length; i++) {
+        state = next(state, Alphabet::toCode(data[i]));
+
+        size_t end = stream.offset + i + 1;
+        if (trie.base[state] < 0) {
+            onMatch(end - depth[state], depth[state]);
+        }
+        for (int o = output[state]; o != EMPTY; o = output[o]) {
+            onMatch(end - depth[o], depth[o]);
+        }
+    }
+
+    stream.state = state;
+    stream.offset += length;
+}
+
+template<typename Alphabet>
+size_t BasicAhoCorasick<Alphabet>::getMemoryUsage() const {
+    return trie.getMemoryUsage() +
+           (fail.capacity() + output.capacity() + depth.capacity()) * sizeof(int);
+}
+
+// The trie's counters, with the link arrays added to the memory figure
+template<typename Alphabet>
+TrieStats BasicAhoCorasick<Alphabet>::stats() const {
+    TrieStats snapshot = trie.stats();
+    snapshot.memoryBytes = getMemoryUsage();
+    return snapshot;
+}
+
+template<typename Alphabet>
+void BasicAhoCorasick<Alphabet>::clear() {
+    trie.clear();
+    fail.clear();
+    output.clear();
+    depth.clear();
+    rootGoto.fill(0);
+    built = false;
+}
+
+// Explicit template instantiations
+template class BasicAhoCorasick<ByteAlphabet>;
+template class BasicAhoCorasick<LowercaseAlphabet>;
+template class BasicAhoCorasick<DnaAlphabet>;
@@ -2,27 +2,240 @@
 #include "standard_trie.h"
 #include "compressed_trie.h"
 #include "double_array_trie.h"
+#include "burst_trie.h"
+#include "hat_trie.h"
+#include "aho_corasick.h"
+#include "encoded_trie.h"
+#include "frozen_trie.h"
+#include "front_coded_dictionary.h"
+#include "durable_trie.h"
+#include "huge_page_allocator.h"
+#include "trie_stats.h"
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <random>
 #include <algorithm>
 #include <iomanip>
+#include <sstream>
+#include <string_view>
+#include <type_traits>
 
 #ifdef __APPLE__
 #include <mach/mach.h>
 #elif __linux__
 #include <fstream>
 #include <sstream>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
 #endif
 
 void BenchmarkResult::calculateAverages() {
     avgInsertTime = datasetSize > 0 ? insertionTime / datasetSize : 0.0;
-    avgSearchTime = datasetSize > 0 ? searchTime / datasetSize : 0.0;
+    avgSearchTime = searchCount > 0 ? searchTime / searchCount : 0.0;
+    avgMissTime = missCount > 0 ? searchMissTime / missCount : 0.0;
+    avgFuzzy1Time = fuzzyCount > 0 ? fuzzyTime1 / fuzzyCount : 0.0;
+    avgFuzzy2Time = fuzzyCount > 0 ? fuzzyTime2 / fuzzyCount : 0.0;
+    avgPatternTime = patternCount > 0 ? patternTime / patternCount : 0.0;
+    avgRangeTime = rangeCount > 0 ? rangeTime / rangeCount : 0.0;
+    dtlbMissesPerSearch = dtlbMisses >= 0 && searchCount > 0 ? double(dtlbMisses) / searchCount : -1.0;
+    scanThroughput = scanTime > 0 ? scanBytes / (scanTime * 1000.0) : 0.0;
+    tokensPerSecond = tokenizeTime > 0 ? tokenCount / (tokenizeTime / 1e6) : 0.0;
+    avgCountTime = countQueries > 0 ? countTime / countQueries : 0.0;
+    avgEnumCountTime = countQueries > 0 ? enumCountTime / countQueries : 0.0;
+    avgRankTime = countQueries > 0 ? rankTime / countQueries : 0.0;
+    avgSelectTime = countQueries > 0 ? selectTime / countQueries : 0.0;
+    avgEncodeTime = encodeCount > 0 ? encodeTime / encodeCount : 0.0;
     memoryPerWord = datasetSize > 0 ? static_cast<double>(memoryUsage) / datasetSize : 0.0;
 }
 
-void BenchmarkResult::print() const {
-    // not used anymore - results go to CSV
+// RFC 4180: fields with a comma, quote or line break go in quotes,
+// with quotes doubled
+static std::string csvField(const std::string& text) {
+    if (text.find_first_of(",\"\r\n") == std::string::npos) {
+        return text;
+    }
+    std::string quoted = "\"";
+    for (char c : text) {
+        quoted += c;
+        if (c == '"') {
+            quoted += '"';
+        }
+    }
+    return quoted + "\"";
+}
+
+static std::string jsonString(const std::string& text) {
+    std::ostringstream out;
+    out << '"';
+    for (char c : text) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (byte < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(byte) << std::dec;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+// The first columns keep the names analyze.py and generate_graphs.py read
+std::string BenchmarkResult::csvHeader() {
+    return "TrieType,DatasetSize,MemoryKB,InsertTimeMS,SearchTimeMS,BytesPerWord,AvgInsertUS,AvgSearchUS,"
+           "KeySource,WordCount,NodeCount,MemoryBytes,SearchMissTimeMS,SearchCount,MissCount,AvgMissUS,"
+           "FuzzyCount,FuzzyMatches,AvgFuzzy1US,AvgFuzzy2US,PatternCount,PatternMatches,AvgPatternUS,"
+           "BuildTimeMS,ScanBytes,ScanMatches,ScanTimeMS,ScanGBps,"
+           "Tokens,TokenizeTimeMS,TokensPerSec,RangeCount,RangeKeys,AvgRangeUS,DTLBMissesPerSearch,"
+           "Splits,Relocations,ProbesPerFindBase,NodesPerLookup,TrainTimeMS,AvgEncodeUS,EncodedKeyRatio,"
+           "Bursts,CountQueries,AvgCountPrefixUS,AvgEnumCountUS,AvgRankUS,AvgSelectUS,"
+           "LogBytes,CheckpointBytes,LogReplayMS,CheckpointMS,RecoveryMS";
+}
+
+std::string BenchmarkResult::toCsv() const {
+    std::ostringstream out;
+    out << csvField(trieType) << ","
+        << datasetSize << ","
+        << std::fixed << std::setprecision(2)
+        << memoryUsage / 1024.0 << ","
+        << insertionTime / 1000.0 << ","
+        << searchTime / 1000.0 << ","
+        << memoryPerWord << ","
+        << std::setprecision(4)
+        << avgInsertTime << ","
+        << avgSearchTime << ","
+        << csvField(keySource) << ","
+        << wordCount << ","
+        << nodeCount << ","
+        << memoryUsage << ","
+        << std::setprecision(2)
+        << searchMissTime / 1000.0 << ","
+        << searchCount << ","
+        << missCount << ","
+        << std::setprecision(4)
+        << avgMissTime << ","
+        << fuzzyCount << ","
+        << fuzzyMatches << ","
+        << avgFuzzy1Time << ","
+        << avgFuzzy2Time << ","
+        << patternCount << ","
+        << patternMatches << ","
+        << avgPatternTime << ","
+        << std::setprecision(2)
+        << buildTime / 1000.0 << ","
+        << scanBytes << ","
+        << scanMatches << ","
+        << scanTime / 1000.0 << ","
+        << std::setprecision(4)
+        << scanThroughput << ","
+        << tokenCount << ","
+        << std::setprecision(2)
+        << tokenizeTime / 1000.0 << ","
+        << std::setprecision(0)
+        << tokensPerSecond << ","
+        << rangeCount << ","
+        << rangeKeys << ","
+        << std::setprecision(3)
+        << avgRangeTime << ","
+        << dtlbMissesPerSearch << ","
+        << splits << ","
+        << relocations << ","
+        << std::setprecision(2)
+        << probesPerFindBase << ","
+        << nodesPerLookup << ","
+        << trainTime / 1000.0 << ","
+        << std::setprecision(4)
+        << avgEncodeTime << ","
+        << encodedKeyRatio << ","
+        << bursts << ","
+        << countQueries << ","
+        << std::setprecision(3)
+        << avgCountTime << ","
+        << avgEnumCountTime << ","
+        << avgRankTime << ","
+        << avgSelectTime << ","
+        << logBytes << ","
+        << checkpointBytes << ","
+        << std::setprecision(2)
+        << logReplayTime / 1000.0 << ","
+        << checkpointTime / 1000.0 << ","
+        << recoveryTime / 1000.0;
+    return out.str();
+}
+
+// One JSON object per line; times in microseconds, memory in bytes
+std::string BenchmarkResult::toJson() const {
+    std::ostringstream out;
+    out << std::setprecision(10)
+        << "{\"trieType\":" << jsonString(trieType)
+        << ",\"keySource\":" << jsonString(keySource)
+        << ",\"datasetSize\":" << datasetSize
+        << ",\"wordCount\":" << wordCount
+        << ",\"insertionTime\":" << insertionTime
+        << ",\"trainTime\":" << trainTime
+        << ",\"buildTime\":" << buildTime
+        << ",\"searchTime\":" << searchTime
+        << ",\"searchMissTime\":" << searchMissTime
+        << ",\"searchCount\":" << searchCount
+        << ",\"dtlbMisses\":" << dtlbMisses
+        << ",\"missCount\":" << missCount
+        << ",\"fuzzyTime1\":" << fuzzyTime1
+        << ",\"fuzzyTime2\":" << fuzzyTime2
+        << ",\"fuzzyCount\":" << fuzzyCount
+        << ",\"fuzzyMatches\":" << fuzzyMatches
+        << ",\"patternTime\":" << patternTime
+        << ",\"patternCount\":" << patternCount
+        << ",\"patternMatches\":" << patternMatches
+        << ",\"rangeTime\":" << rangeTime
+        << ",\"rangeCount\":" << rangeCount
+        << ",\"rangeKeys\":" << rangeKeys
+        << ",\"scanTime\":" << scanTime
+        << ",\"scanBytes\":" << scanBytes
+        << ",\"scanMatches\":" << scanMatches
+        << ",\"tokenizeTime\":" << tokenizeTime
+        << ",\"tokenCount\":" << tokenCount
+        << ",\"countTime\":" << countTime
+        << ",\"enumCountTime\":" << enumCountTime
+        << ",\"rankTime\":" << rankTime
+        << ",\"selectTime\":" << selectTime
+        << ",\"countQueries\":" << countQueries
+        << ",\"encodeTime\":" << encodeTime
+        << ",\"encodeCount\":" << encodeCount
+        << ",\"encodedKeyRatio\":" << encodedKeyRatio
+        << ",\"logReplayTime\":" << logReplayTime
+        << ",\"checkpointTime\":" << checkpointTime
+        << ",\"recoveryTime\":" << recoveryTime
+        << ",\"logBytes\":" << logBytes
+        << ",\"checkpointBytes\":" << checkpointBytes
+        << ",\"memoryUsage\":" << memoryUsage
+        << ",\"nodeCount\":" << nodeCount
+        << ",\"splits\":" << splits
+        << ",\"relocations\":" << relocations
+        << ",\"bursts\":" << bursts
+        << ",\"probesPerFindBase\":" << probesPerFindBase
+        << ",\"nodesPerLookup\":" << nodesPerLookup
+        << ",\"avgInsertTime\":" << avgInsertTime
+        << ",\"avgSearchTime\":" << avgSearchTime
+        << ",\"avgMissTime\":" << avgMissTime
+        << ",\"avgFuzzy1Time\":" << avgFuzzy1Time
+        << ",\"avgFuzzy2Time\":" << avgFuzzy2Time
+        << ",\"avgPatternTime\":" << avgPatternTime
+        << ",\"avgRangeTime\":" << avgRangeTime
+        << ",\"dtlbMissesPerSearch\":" << dtlbMissesPerSearch
+        << ",\"scanThroughput\":" << scanThroughput
+        << ",\"tokensPerSecond\":" << tokensPerSecond
+        << ",\"avgCountTime\":" << avgCountTime
+        << ",\"avgEnumCountTime\":" << avgEnumCountTime
+        << ",\"avgRankTime\":" << avgRankTime
+        << ",\"avgSelectTime\":" << avgSelectTime
+        << ",\"avgEncodeTime\":" << avgEncodeTime
+        << ",\"memoryPerWord\":" << memoryPerWord
+        << "}";
+    return out.str();
 }
 
 void Benchmark::loadDictionary(const std::string& filename) {
@@ -42,13 +255,13 @@ void Benchmark::loadDictionary(const std::string& filename) {
         }
     }
     
-    std::cout << "Loaded " << dataset.size() << " words from " << filename << std::endl;
+    keySource = filename;
+    std::cerr << "Loaded " << dataset.size() << " words from " << filename << std::endl;
 }
 
 void Benchmark::generateRandomStrings(size_t count, size_t minLen, size_t maxLen) {
     static const char charset[] = "abcdefghijklmnopqrstuvwxyz";
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937& gen = rng;
     std::uniform_int_distribution<> lenDist(minLen, maxLen);
     std::uniform_int_distribution<> charDist(0, sizeof(charset) - 2);
     
@@ -64,41 +277,288 @@ void Benchmark::generateRandomStrings(size_t count, size_t minLen, size_t maxLen
             str += charset[charDist(gen)];
         }
         
-        dataset.push_back(str);
+        dataset.push_back(std::move(str));
     }
     
-    std::cout << "Generated " << count << " random strings" << std::endl;
+    keySource = "random";
+    std::cerr << "Generated " << count << " random strings" << std::endl;
 }
 
 void Benchmark::loadFromFile(const std::string& filename) {
     loadDictionary(filename);  // Same logic for now
 }
 
+// Also drops every query set derived from the keys, so the next dataset
+// doesn't run the previous one's queries
+void Benchmark::clearDataset() {
+    dataset.clear();
+    searchKeys.clear();
+    missKeys.clear();
+    fuzzyKeys.clear();
+    patterns.clear();
+    corpus.clear();
+}
+
+void Benchmark::truncateDataset(size_t count) {
+    if (dataset.size() > count) {
+        dataset.resize(count);
+        dataset.shrink_to_fit();
+    }
+}
+
+// Optional workloads only run on tries that provide the operation
+template<typename T, typename = void>
+struct HasFuzzySearch : std::false_type {};
+
+template<typename T>
+struct HasFuzzySearch<T, std::void_t<decltype(std::declval<const T&>().fuzzySearch(std::string(), 1))>>
+    : std::true_type {};
+
+template<typename T, typename = void>
+struct HasMatchPattern : std::false_type {};
+
+template<typename T>
+struct HasMatchPattern<T, std::void_t<decltype(std::declval<const T&>().matchPattern(std::string()))>>
+    : std::true_type {};
+
+template<typename T, typename = void>
+struct HasRangeScan : std::false_type {};
+
+template<typename T>
+struct HasRangeScan<T, std::void_t<decltype(std::declval<const T&>().rangeScan(
+    std::string(), std::string(), std::function<bool(const std::string&)>()))>> : std::true_type {};
+
+template<typename T, typename = void>
+struct HasScan : std::false_type {};
+
+template<typename T>
+struct HasScan<T, std::void_t<decltype(std::declval<const T&>().scan(
+    std::string(), std::function<void(size_t, size_t)>()))>> : std::true_type {};
+
+template<typename T, typename = void>
+struct HasLongestPrefixMatch : std::false_type {};
+
+template<typename T>
+struct HasLongestPrefixMatch<T, std::void_t<decltype(std::declval<const T&>().longestPrefixMatch(
+    std::string_view()))>> : std::true_type {};
+
+template<typename T, typename = void>
+struct HasStats : std::false_type {};
+
+template<typename T>
+struct HasStats<T, std::void_t<decltype(std::declval<const T&>().stats())>> : std::true_type {};
+
+// Structures that need a finishing pass after the last insert
+template<typename T, typename = void>
+struct HasBuild : std::false_type {};
+
+template<typename T>
+struct HasBuild<T, std::void_t<decltype(std::declval<T&>().build())>> : std::true_type {};
+
+// Structures whose storage grows with slack that can be trimmed afterwards
+template<typename T, typename = void>
+struct HasCompact : std::false_type {};
+
+template<typename T>
+struct HasCompact<T, std::void_t<decltype(std::declval<T&>().compact())>> : std::true_type {};
+
+// Tries that keep per-node key counts for order statistics
+template<typename T, typename = void>
+struct HasCountPrefix : std::false_type {};
+
+template<typename T>
+struct HasCountPrefix<T, std::void_t<decltype(std::declval<const T&>().countPrefix(std::string())),
+                                     decltype(std::declval<const T&>().rank(std::string())),
+                                     decltype(std::declval<const T&>().select(size_t()))>> : std::true_type {};
+
+// Tries that compress keys with a KeyEncoder trained before inserting
+template<typename T, typename = void>
+struct HasTrain : std::false_type {};
+
+template<typename T>
+struct HasTrain<T, std::void_t<decltype(std::declval<T&>().train(std::vector<std::string>()))>>
+    : std::true_type {};
+
+template<typename T, typename = void>
+struct HasEncoder : std::false_type {};
+
+template<typename T>
+struct HasEncoder<T, std::void_t<decltype(std::declval<const T&>().getEncoder().encode(std::string_view()))>>
+    : std::true_type {};
+
+// Tries that log their changes to a directory
+template<typename T, typename = void>
+struct HasOpen : std::false_type {};
+
+template<typename T>
+struct HasOpen<T, std::void_t<decltype(std::declval<T&>().open(std::string())),
+                              decltype(std::declval<T&>().checkpoint())>> : std::true_type {};
+
 template<typename TrieType>
 BenchmarkResult Benchmark::run(const std::string& trieTypeName) {
     BenchmarkResult result;
     result.trieType = trieTypeName;
+    result.keySource = keySource;
     result.datasetSize = dataset.size();
     
     // Prepare search keys
-    prepareSearchKeys(std::min(dataset.size(), size_t(1000)));
-    prepareMissKeys(std::min(dataset.size() / 10, size_t(1000)));
+    prepareSearchKeys(std::min(dataset.size(), queryCount));
+    prepareMissKeys(std::min(dataset.size() / 10, queryCount));
     
     // Create trie instance
     TrieType trie;
     
+    // Train on an evenly spaced sample of the keys
+    if constexpr (HasTrain<TrieType>::value) {
+        std::vector<std::string> sample;
+        size_t stride = std::max<size_t>(1, dataset.size() / 10000);
+        for (size_t i = 0; i < dataset.size(); i += stride) {
+            sample.push_back(dataset[i]);
+        }
+        Timer timer;
+        trie.train(sample);
+        result.trainTime = timer.elapsed();
+    }
+    
+    // Durable tries log to a fresh directory; the last group commit
+    // counts as part of inserting
+    std::string logDirectory;
+    if constexpr (HasOpen<TrieType>::value) {
+        auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        logDirectory = (std::filesystem::temp_directory_path() /
+                        ("trie_benchmark_wal_" + std::to_string(stamp))).string();
+        trie.open(logDirectory);
+    }
+    
     // Measure insertion time
-    result.insertionTime = measureInsertionTime(trie);
+    result.insertionTime = result.trainTime + measureInsertionTime(trie);
+    
+    if constexpr (HasOpen<TrieType>::value) {
+        Timer timer;
+        trie.commit();
+        result.insertionTime += timer.elapsed();
+    }
+    
+    if constexpr (HasBuild<TrieType>::value) {
+        Timer timer;
+        trie.build();
+        result.buildTime = timer.elapsed();
+        result.insertionTime += result.buildTime;
+    } else if constexpr (HasCompact<TrieType>::value) {
+        Timer timer;
+        trie.compact();
+        result.buildTime = timer.elapsed();
+        result.insertionTime += result.buildTime;
+    }
     
     // Measure search time (hits)
-    result.searchTime = measureSearchTime(trie, searchKeys);
+    if (hasWorkload("search")) {
+        TlbMissCounter tlb;
+        tlb.start();
+        result.searchTime = measureSearchTime(trie, searchKeys);
+        result.dtlbMisses = tlb.stop();
+        result.searchCount = searchKeys.size();
+    }
     
     // Measure search time (misses)
-    result.searchMissTime = measureSearchTime(trie, missKeys);
+    if (hasWorkload("miss")) {
+        result.searchMissTime = measureSearchTime(trie, missKeys);
+        result.missCount = missKeys.size();
+    }
+    
+    // Measure fuzzy search latency at distance 1 and 2
+    if constexpr (HasFuzzySearch<TrieType>::value) {
+        if (hasWorkload("fuzzy")) {
+            prepareFuzzyKeys(std::min(searchKeys.size(), size_t(100)));
+            result.fuzzyTime1 = measureFuzzyTime(trie, 1, result.fuzzyMatches);
+            result.fuzzyTime2 = measureFuzzyTime(trie, 2, result.fuzzyMatches);
+            result.fuzzyCount = fuzzyKeys.size();
+        }
+    }
+    
+    // Measure wildcard pattern queries
+    if constexpr (HasMatchPattern<TrieType>::value) {
+        if (hasWorkload("pattern")) {
+            preparePatterns(std::min(searchKeys.size(), size_t(100)));
+            result.patternTime = measurePatternTime(trie, result.patternMatches);
+            result.patternCount = patterns.size();
+        }
+    }
+    
+    // Measure paginated listing: seek to a key, stream one page
+    if constexpr (HasRangeScan<TrieType>::value) {
+        if (hasWorkload("range")) {
+            result.rangeTime = measureRangeTime(trie, result.rangeKeys);
+            result.rangeCount = searchKeys.size();
+        }
+    }
+    
+    // Measure prefix counts, rank and select against counting by enumeration
+    if constexpr (HasCountPrefix<TrieType>::value) {
+        if (hasWorkload("count")) {
+            measureOrderStatistics(trie, result);
+        }
+    }
+    
+    // Both text workloads share one corpus
+    if ((HasScan<TrieType>::value && hasWorkload("scan")) ||
+        (HasLongestPrefixMatch<TrieType>::value && hasWorkload("tokenize"))) {
+        prepareCorpus(8 << 20);
+    }
+    
+    // Measure multi-pattern scanning throughput over a text corpus
+    if constexpr (HasScan<TrieType>::value) {
+        if (hasWorkload("scan")) {
+            result.scanTime = measureScanTime(trie, result.scanMatches);
+            result.scanBytes = corpus.size();
+        }
+    }
+    
+    // Measure greedy longest-match tokenizing of the same corpus
+    if constexpr (HasLongestPrefixMatch<TrieType>::value) {
+        if (hasWorkload("tokenize")) {
+            result.tokenizeTime = measureTokenizeTime(trie, result.tokenCount);
+        }
+    }
+    
+    // Encoding is part of every lookup; time it alone to show its share
+    if constexpr (HasEncoder<TrieType>::value) {
+        size_t rawBytes = 0;
+        size_t encodedBytes = 0;
+        Timer timer;
+        for (const auto& key : searchKeys) {
+            encodedBytes += trie.getEncoder().encode(key).size();
+        }
+        result.encodeTime = timer.elapsed();
+        result.encodeCount = searchKeys.size();
+        for (const auto& key : searchKeys) {
+            rawBytes += key.size();
+        }
+        result.encodedKeyRatio = rawBytes > 0 ? static_cast<double>(encodedBytes) / rawBytes : 0.0;
+    }
     
     // Get memory usage
     result.memoryUsage = trie.getMemoryUsage();
     result.nodeCount = trie.getNodeCount();
+    result.wordCount = trie.getWordCount();
+    
+    if constexpr (HasStats<TrieType>::value) {
+        TrieStats stats = trie.stats();
+        result.splits = stats.splits;
+        result.relocations = stats.relocations;
+        result.bursts = stats.bursts;
+        result.probesPerFindBase = stats.probesPerFindBase();
+        result.nodesPerLookup = stats.nodesPerLookup();
+    }
+    
+    if constexpr (HasOpen<TrieType>::value) {
+        if (hasWorkload("restart")) {
+            measureRestart(trie, logDirectory, result);
+        }
+        trie.close();
+        std::error_code ignored;
+        std::filesystem::remove_all(logDirectory, ignored);
+    }
     
     // Calculate derived metrics
     result.calculateAverages();
@@ -111,20 +571,17 @@ void Benchmark::prepareSearchKeys(size_t sampleSize) {
     
     if (dataset.empty()) return;
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dist(0, dataset.size() - 1);
+    std::uniform_int_distribution<size_t> dist(0, dataset.size() - 1);
     
     for (size_t i = 0; i < sampleSize; i++) {
-        searchKeys.push_back(dataset[dist(gen)]);
+        searchKeys.push_back(dataset[dist(rng)]);
     }
 }
 
 void Benchmark::prepareMissKeys(size_t sampleSize) {
     missKeys.clear();
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937& gen = rng;
     std::uniform_int_distribution<> lenDist(5, 15);
     std::uniform_int_distribution<> charDist('a', 'z');
     
@@ -140,6 +597,67 @@ void Benchmark::prepareMissKeys(size_t sampleSize) {
     }
 }
 
+// Fuzzy queries are hits with one random substitution, insertion or
+// deletion. An empty key can only get an insertion.
+void Benchmark::prepareFuzzyKeys(size_t sampleSize) {
+    fuzzyKeys.clear();
+    
+    std::uniform_int_distribution<> editDist(0, 2);
+    std::uniform_int_distribution<> charDist('a', 'z');
+    
+    for (size_t i = 0; i < sampleSize; i++) {
+        std::string key = searchKeys[i];
+        if (key.empty()) {
+            fuzzyKeys.push_back(std::string(1, static_cast<char>(charDist(rng))));
+            continue;
+        }
+        std::uniform_int_distribution<size_t> posDist(0, key.size() - 1);
+        size_t pos = posDist(rng);
+        
+        switch (editDist(rng)) {
+            case 0: key[pos] = static_cast<char>(charDist(rng)); break;
+            case 1: key.insert(key.begin() + pos, static_cast<char>(charDist(rng))); break;
+            default: if (key.size() > 1) key.erase(pos, 1); break;
+        }
+        fuzzyKeys.push_back(key);
+    }
+}
+
+// Patterns keep a short literal prefix of a real word and wildcard the rest,
+// alternating "ab?d*" and "a?c[a-m]*" shapes
+void Benchmark::preparePatterns(size_t sampleSize) {
+    patterns.clear();
+    
+    for (size_t i = 0; i < sampleSize; i++) {
+        const std::string& key = searchKeys[i];
+        if (key.size() < 4) {
+            patterns.push_back(key + "*");
+        } else if (i % 2 == 0) {
+            patterns.push_back(key.substr(0, 2) + "?" + key[3] + "*");
+        } else {
+            patterns.push_back(key.substr(0, 1) + "?" + key[2] + "[a-m]*");
+        }
+    }
+}
+
+// Dataset words separated by spaces and bits of random noise
+void Benchmark::prepareCorpus(size_t bytes) {
+    corpus.clear();
+    corpus.reserve(bytes + 64);
+    
+    std::uniform_int_distribution<size_t> wordDist(0, dataset.size() - 1);
+    std::uniform_int_distribution<> noiseDist(0, 3);
+    std::uniform_int_distribution<> charDist('a', 'z');
+    
+    while (corpus.size() < bytes) {
+        corpus += dataset[wordDist(rng)];
+        for (int i = noiseDist(rng); i > 0; i--) {
+            corpus += static_cast<char>(charDist(rng));
+        }
+        corpus += ' ';
+    }
+}
+
 template<typename TrieType>
 double Benchmark::measureInsertionTime(TrieType& trie) {
     Timer timer;
@@ -162,6 +680,221 @@ double Benchmark::measureSearchTime(const TrieType& trie, const std::vector<std:
     return timer.elapsed();
 }
 
+template<typename TrieType>
+double Benchmark::measureFuzzyTime(const TrieType& trie, int maxDistance, size_t& matches) {
+    Timer timer;
+    
+    for (const auto& key : fuzzyKeys) {
+        matches += trie.fuzzySearch(key, maxDistance).size();
+    }
+    
+    return timer.elapsed();
+}
+
+template<typename TrieType>
+double Benchmark::measurePatternTime(const TrieType& trie, size_t& matches) {
+    Timer timer;
+    
+    for (const auto& pattern : patterns) {
+        matches += trie.matchPattern(pattern).size();
+    }
+    
+    return timer.elapsed();
+}
+
+// Each page starts at an existing key and runs to the end of the key
+// space, so only the page size and the early stop bound the work
+template<typename TrieType>
+double Benchmark::measureRangeTime(const TrieType& trie, size_t& keys) {
+    Timer timer;
+    
+    for (const auto& key : searchKeys) {
+        size_t page = 0;
+        trie.rangeScan(key, "", [&](const std::string&) {
+            return ++page < pageSize;
+        });
+        keys += page;
+    }
+    
+    return timer.elapsed();
+}
+
+// The corpus is fed in 64 KiB buffers through the streaming interface, the
+// way a document stream would arrive
+template<typename TrieType>
+double Benchmark::measureScanTime(const TrieType& trie, size_t& matches) {
+    const size_t chunk = 64 << 10;
+    typename TrieType::StreamState stream;
+    auto count = [&matches](size_t, size_t) { matches++; };
+    
+    Timer timer;
+    
+    for (size_t pos = 0; pos < corpus.size(); pos += chunk) {
+        trie.scan(corpus.data() + pos, std::min(chunk, corpus.size() - pos), stream, count);
+    }
+    
+    return timer.elapsed();
+}
+
+// Takes the longest dictionary word at each position; a byte no word
+// starts with is skipped without producing a token
+template<typename TrieType>
+double Benchmark::measureTokenizeTime(const TrieType& trie, size_t& tokens) {
+    std::string_view text(corpus);
+    
+    Timer timer;
+    
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t length = trie.longestPrefixMatch(text.substr(pos));
+        if (length == 0) {
+            pos++;
+        } else {
+            tokens++;
+            pos += length;
+        }
+    }
+    
+    return timer.elapsed();
+}
+
+// Prefixes are the first two characters of the search keys, broad
+// enough that enumerating them is the expensive part of the baseline
+template<typename TrieType>
+void Benchmark::measureOrderStatistics(const TrieType& trie, BenchmarkResult& result) {
+    if (trie.getWordCount() == 0) {
+        return;
+    }
+    
+    std::vector<std::string> prefixes;
+    for (const auto& key : searchKeys) {
+        prefixes.push_back(key.substr(0, 2));
+    }
+    std::vector<size_t> positions;
+    std::uniform_int_distribution<size_t> positionDist(0, trie.getWordCount() - 1);
+    for (size_t i = 0; i < searchKeys.size(); i++) {
+        positions.push_back(positionDist(rng));
+    }
+    
+    size_t counted = 0;
+    size_t enumerated = 0;
+    
+    Timer timer;
+    for (const auto& prefix : prefixes) {
+        counted += trie.countPrefix(prefix);
+    }
+    result.countTime = timer.elapsed();
+    
+    timer.reset();
+    for (const auto& prefix : prefixes) {
+        trie.rangeScan(prefix, "", [&](const std::string& key) {
+            if (key.compare(0, prefix.size(), prefix) != 0) {
+                return false;
+            }
+            enumerated++;
+            return true;
+        });
+    }
+    result.enumCountTime = timer.elapsed();
+    
+    if (counted != enumerated) {
+        std::cerr << "countPrefix disagrees with enumeration: " << counted << " vs " << enumerated << std::endl;
+    }
+    
+    timer.reset();
+    for (const auto& key : searchKeys) {
+        counted += trie.rank(key);
+    }
+    result.rankTime = timer.elapsed();
+    
+    timer.reset();
+    for (size_t position : positions) {
+        counted += trie.select(position).size();
+    }
+    result.selectTime = timer.elapsed();
+    
+    result.countQueries = searchKeys.size();
+}
+
+// Restarts twice from what the benchmarked trie left on disk: once by
+// replaying the whole log, once from a checkpoint written after that
+template<typename TrieType>
+void Benchmark::measureRestart(TrieType& trie, const std::string& directory, BenchmarkResult& result) {
+    size_t expected = trie.getWordCount();
+    result.logBytes = trie.getLogBytes();
+    trie.close();
+    
+    {
+        TrieType replayed;
+        Timer timer;
+        replayed.open(directory);
+        result.logReplayTime = timer.elapsed();
+        
+        timer.reset();
+        replayed.checkpoint();
+        result.checkpointTime = timer.elapsed();
+        result.checkpointBytes = replayed.getCheckpointBytes();
+        
+        if (replayed.getWordCount() != expected) {
+            std::cerr << "Log replay restored " << replayed.getWordCount() << " of " << expected << " keys" << std::endl;
+        }
+    }
+    
+    TrieType restored;
+    Timer timer;
+    restored.open(directory);
+    result.recoveryTime = timer.elapsed();
+    
+    if (restored.getWordCount() != expected) {
+        std::cerr << "Checkpoint restored " << restored.getWordCount() << " of " << expected << " keys" << std::endl;
+    }
+}
+
+#ifdef __linux__
+TlbMissCounter::TlbMissCounter() : fd(-1) {
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+TlbMissCounter::~TlbMissCounter() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+void TlbMissCounter::start() {
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+long long TlbMissCounter::stop() {
+    if (fd < 0) {
+        return -1;
+    }
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    long long count = 0;
+    if (read(fd, &count, sizeof(count)) != sizeof(count)) {
+        return -1;
+    }
+    return count;
+}
+#else
+TlbMissCounter::TlbMissCounter() : fd(-1) {}
+TlbMissCounter::~TlbMissCounter() {}
+void TlbMissCounter::start() {}
+long long TlbMissCounter::stop() { return -1; }
+#endif
+
 size_t Benchmark::getCurrentMemoryUsage() {
 #ifdef __APPLE__
     struct task_basic_info info;
@@ -182,7 +915,81 @@ size_t Benchmark::getCurrentMemoryUsage() {
     return 0;
 }
 
-// Explicit template instantiations
-template BenchmarkResult Benchmark::run<StandardTrie>(const std::string&);
-template BenchmarkResult Benchmark::run<CompressedTrie>(const std::string&);
-template BenchmarkResult Benchmark::run<DoubleArrayTrie>(const std::string&);
+template<typename TrieType>
+static TrieVariant makeVariant(const std::string& name, const std::string& displayName) {
+    return {name, displayName, [displayName](Benchmark& bench) {
+        return bench.run<TrieType>(displayName);
+    }};
+}
+
+// Same, built and queried under a different PagePolicy
+template<typename TrieType>
+static TrieVariant makeVariant(const std::string& name, const std::string& displayName, PagePolicy pages) {
+    return {name, displayName, [displayName, pages](Benchmark& bench) {
+        ScopedPagePolicy scoped(pages);
+        return bench.run<TrieType>(displayName);
+    }};
+}
+
+static PagePolicy smallPages() {
+    PagePolicy policy;
+    policy.hugePages = false;
+    return policy;
+}
+
+static PagePolicy prefaulted() {
+    PagePolicy policy;
+    policy.populate = true;
+    return policy;
+}
+
+const std::vector<TrieVariant>& Benchmark::variants() {
+    static const std::vector<TrieVariant> registry = {
+        makeVariant<StandardTrie>("standard", "Standard Trie"),
+        makeVariant<CompressedTrie>("compressed", "Compressed Trie"),
+        makeVariant<DoubleArrayTrie>("double_array", "Double-Array Trie"),
+        makeVariant<BurstTrie>("burst", "Burst Trie"),
+        makeVariant<HatTrie>("hat", "HAT-trie"),
+        makeVariant<BasicStandardTrie<LowercaseAlphabet>>("standard_az", "Standard Trie (a-z)"),
+        makeVariant<BasicCompressedTrie<LowercaseAlphabet>>("compressed_az", "Compressed Trie (a-z)"),
+        makeVariant<BasicDoubleArrayTrie<LowercaseAlphabet>>("double_array_az", "Double-Array Trie (a-z)"),
+        makeVariant<BasicBurstTrie<LowercaseAlphabet>>("burst_az", "Burst Trie (a-z)"),
+        makeVariant<BasicHatTrie<LowercaseAlphabet>>("hat_az", "HAT-trie (a-z)"),
+        makeVariant<DoubleArrayTrie>("double_array_4k", "Double-Array Trie (4K pages)", smallPages()),
+        makeVariant<BasicDoubleArrayTrie<LowercaseAlphabet>>("double_array_az_4k", "Double-Array Trie (a-z, 4K pages)",
+                                                             smallPages()),
+        makeVariant<DoubleArrayTrie>("double_array_prefault", "Double-Array Trie (pre-faulted)", prefaulted()),
+        makeVariant<EncodedTrie<StandardTrie>>("standard_hope", "Standard Trie + HOPE"),
+        makeVariant<EncodedTrie<CompressedTrie>>("compressed_hope", "Compressed Trie + HOPE"),
+        makeVariant<EncodedTrie<DoubleArrayTrie>>("double_array_hope", "Double-Array Trie + HOPE"),
+        makeVariant<FrozenTrie<StandardTrie>>("standard_frozen", "Standard Trie -> Double-Array"),
+        makeVariant<FrozenTrie<CompressedTrie>>("compressed_frozen", "Compressed Trie -> Double-Array"),
+        makeVariant<FrozenTrie<BasicCompressedTrie<LowercaseAlphabet>>>("compressed_frozen_az",
+                                                                        "Compressed Trie -> Double-Array (a-z)"),
+        makeVariant<FrozenTrie<StandardTrie, ToFlatLayout>>("standard_flat", "Standard Trie (relayout)"),
+        makeVariant<FrozenTrie<CompressedTrie, ToFlatLayout>>("compressed_flat", "Compressed Trie (relayout)"),
+        makeVariant<FrozenTrie<BasicCompressedTrie<LowercaseAlphabet>, ToFlatLayout>>("compressed_flat_az",
+                                                                                       "Compressed Trie (relayout, a-z)"),
+        makeVariant<FrozenTrie<CompressedTrie, ToDawg<ByteAlphabet>>>("dawg", "DAWG"),
+        makeVariant<FrozenTrie<BasicCompressedTrie<LowercaseAlphabet>, ToDawg<LowercaseAlphabet>>>("dawg_az",
+                                                                                                    "DAWG (a-z)"),
+        makeVariant<FrontCodedDictionary>("front_coded", "Front-Coded Array"),
+        makeVariant<DurableTrie<CompressedTrie>>("compressed_durable", "Compressed Trie + WAL"),
+        makeVariant<AhoCorasick>("aho_corasick", "Aho-Corasick (DA)"),
+        makeVariant<BasicAhoCorasick<LowercaseAlphabet>>("aho_corasick_az", "Aho-Corasick (DA, a-z)"),
+    };
+    return registry;
+}
+
+const TrieVariant* Benchmark::findVariant(const std::string& name) {
+    for (const auto& variant : variants()) {
+        if (variant.name == name) {
+            return &variant;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::string> Benchmark::workloadNames() {
+    return {"insert", "search", "miss", "fuzzy", "pattern", "range", "count", "scan", "tokenize", "restart"};
+}
@@ -0,0 +1,330 @@
+#include "burst_trie.h"
+#include <utility>
+
+template<typename Alphabet>
+BasicBurstTrie<Alphabet>::BasicBurstTrie() : wordCount(0), nodeCount(1), memoryBytes(sizeof(TrieNode)) {
+    root = std::make_unique<TrieNode>(false);
+}
+
+template<typename Alphabet>
+void BasicBurstTrie<Alphabet>::insert(const std::string& word) {
+    if (!isValidKey<Alphabet>(word)) return;
+
+    TrieNode* node = root.get();
+    size_t depth = 0;
+
+    while (!node->isContainer && depth < word.size()) {
+        int code = Alphabet::toCode(word[depth]);
+        TrieNode* child = node->children.find(code);
+        node = child ? child : addChild(node, code);
+        depth++;
+    }
+
+    if (depth == word.size()) {
+        if (!node->isEndOfWord) {
+            node->isEndOfWord = true;
+            wordCount++;
+        }
+        return;
+    }
+
+    std::string_view rest(word);
+    rest.remove_prefix(depth);
+
+    bool found;
+    size_t pos = seekEntry(node->bucket, rest, found);
+    if (found) {
+        return;
+    }
+
+    size_t before = bucketBytes(node);
+    insertPacked(node->bucket, pos, rest);
+    node->bucketCount++;
+    wordCount++;
+    memoryBytes += bucketBytes(node) - before;
+
+    if (node->bucketCount > BURST_THRESHOLD) {
+        burst(node);
+    }
+}
+
+template<typename Alphabet>
+bool BasicBurstTrie<Alphabet>::search(const std::string& word) const {
+    size_t depth;
+    const TrieNode* node = descend(word, depth);
+    if (!node) {
+        return false;
+    }
+    if (depth == word.size()) {
+        return node->isEndOfWord;
+    }
+
+    bool found;
+    seekEntry(node->bucket, std::string_view(word).substr(depth), found);
+    return found;
+}
+
+// Nodes without keys below them are pruned by remove, so reaching the end
+// of the prefix at a node is enough. Inside a container the first suffix
+// at or after the rest of the prefix decides.
+template<typename Alphabet>
+bool BasicBurstTrie<Alphabet>::startsWith(const std::string& prefix) const {
+    size_t depth;
+    const TrieNode* node = descend(prefix, depth);
+    if (!node) {
+        return false;
+    }
+    if (depth == prefix.size()) {
+        return true;
+    }
+
+    std::string_view rest = std::string_view(prefix).substr(depth);
+    bool found;
+    size_t pos = seekEntry(node->bucket, rest, found);
+    if (found) {
+        return true;
+    }
+    if (pos == node->bucket.size()) {
+        return false;
+    }
+    std::string_view entry;
+    readPacked(node->bucket, pos, entry);
+    return entry.compare(0, rest.size(), rest) == 0;
+}
+
+template<typename Alphabet>
+bool BasicBurstTrie<Alphabet>::remove(const std::string& word) {
+    std::vector<std::pair<TrieNode*, int>> path;  // parent and code of each step
+    TrieNode* node = root.get();
+    size_t depth = 0;
+
+    while (!node->isContainer && depth < word.size()) {
+        int code = Alphabet::toCode(word[depth]);
+        TrieNode* child = node->children.find(code);
+        if (!child) {
+            return false;
+        }
+        path.push_back({node, code});
+        node = child;
+        depth++;
+    }
+
+    if (depth == word.size()) {
+        if (!node->isEndOfWord) {
+            return false;
+        }
+        node->isEndOfWord = false;
+    } else {
+        bool found;
+        size_t pos = seekEntry(node->bucket, std::string_view(word).substr(depth), found);
+        if (!found) {
+            return false;
+        }
+        erasePacked(node->bucket, pos);
+        node->bucketCount--;
+    }
+    wordCount--;
+
+    // Drop nodes left with nothing below them
+    while (!path.empty() && !node->isEndOfWord && node->bucketCount == 0 && node->children.empty()) {
+        TrieNode* parent = path.back().first;
+        int code = path.back().second;
+        path.pop_back();
+
+        size_t tableBytes = parent->children.heapBytes();
+        memoryBytes -= sizeof(TrieNode) + bucketBytes(node) + node->children.heapBytes();
+        parent->children.erase(code);
+        memoryBytes -= tableBytes - parent->children.heapBytes();
+        nodeCount--;
+        node = parent;
+    }
+    return true;
+}
+
+// Follows trie nodes until the key runs out or a container takes over.
+// Returns null if a branch is missing; depth is the characters consumed.
+template<typename Alphabet>
+const typename BasicBurstTrie<Alphabet>::TrieNode*
+BasicBurstTrie<Alphabet>::descend(const std::string& key, size_t& depth) const {
+    const TrieNode* node = root.get();
+    depth = 0;
+
+    while (!node->isContainer && depth < key.size()) {
+        node = node->children.find(Alphabet::toCode(key[depth]));
+        if (!node) {
+            break;
+        }
+        depth++;
+    }
+
+    lookups.add(1);
+    nodesVisited.add(depth);
+    return node;
+}
+
+template<typename Alphabet>
+typename BasicBurstTrie<Alphabet>::TrieNode* BasicBurstTrie<Alphabet>::addChild(TrieNode* node, int code) {
+    size_t tableBytes = node->children.heapBytes();
+    TrieNode* child = node->children.insert(code, std::make_unique<TrieNode>(true));
+    nodeCount++;
+    memoryBytes += sizeof(TrieNode) + node->children.heapBytes() - tableBytes;
+    return child;
+}
+
+// Suffixes come out of the buffer in order, so appending each one to its
+// new container keeps those sorted too. A child that received every
+// suffix may be over the threshold itself and bursts in turn.
+template<typename Alphabet>
+void BasicBurstTrie<Alphabet>::burst(TrieNode* node) {
+    std::string entries;
+    memoryBytes -= bucketBytes(node);
+    entries.swap(node->bucket);
+    node->bucketCount = 0;
+    node->isContainer = false;
+    bursts.add(1);
+
+    std::string_view entry;
+    for (size_t pos = 0; pos < entries.size();) {
+        pos = readPacked(entries, pos, entry);
+
+        int code = Alphabet::toCode(entry[0]);
+        TrieNode* child = node->children.find(code);
+        if (!child) {
+            child = addChild(node, code);
+        }
+
+        if (entry.size() == 1) {
+            child->isEndOfWord = true;
+        } else {
+            size_t before = bucketBytes(child);
+            insertPacked(child->bucket, child->bucket.size(), entry.substr(1));
+            child->bucketCount++;
+            memoryBytes += bucketBytes(child) - before;
+        }
+    }
+
+    node->children.forEach([this](int, TrieNode* child) {
+        if (child->bucketCount > BURST_THRESHOLD) {
+            burst(child);
+        }
+    });
+}
+
+template<typename Alphabet>
+void BasicBurstTrie<Alphabet>::rangeScan(const std::string& lo, const std::string& hi,
+                                         const KeyCallback& onKey) const {
+    std::string word;
+    rangeScanHelper(root.get(), true, lo, hi, word, onKey);
+}
+
+// tight: word is still a prefix of lo, so only children at or after
+// lo[depth] (or suffixes at or after the rest of lo) can hold keys in
+// range. Returns false once the scan is over.
+template<typename Alphabet>
+bool BasicBurstTrie<Alphabet>::rangeScanHelper(const TrieNode* node, bool tight, const std::string& lo,
+                                               const std::string& hi, std::string& word,
+                                               const KeyCallback& onKey) const {
+    // every key below this node is >= word
+    if (!hi.empty() && word >= hi) {
+        return false;
+    }
+
+    size_t depth = word.size();
+    if (tight && depth == lo.size()) {
+        tight = false;
+    }
+
+    if (!tight && node->isEndOfWord && !onKey(word)) {
+        return false;
+    }
+
+    if (node->isContainer) {
+        size_t pos = 0;
+        if (tight) {
+            bool found;
+            pos = seekEntry(node->bucket, std::string_view(lo).substr(depth), found);
+        }
+
+        std::string_view entry;
+        while (pos < node->bucket.size()) {
+            pos = readPacked(node->bucket, pos, entry);
+            word.append(entry);
+            bool more = (hi.empty() || word < hi) && onKey(word);
+            word.resize(depth);
+            if (!more) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int loCode = tight ? Alphabet::toCode(lo[depth]) : -1;
+    int firstCode = tight ? lowerBoundCode<Alphabet>(lo[depth]) : 0;
+
+    return node->children.forEachFrom(firstCode, [&](int code, const TrieNode* child) {
+        word.push_back(Alphabet::toChar(code));
+        bool more = rangeScanHelper(child, code == loCode, lo, hi, word, onKey);
+        word.pop_back();
+        return more;
+    });
+}
+
+template<typename Alphabet>
+size_t BasicBurstTrie<Alphabet>::bucketBytes(const TrieNode* node) {
+    return packedHeapBytes(node->bucket);
+}
+
+// Position of the first entry >= key (bucket.size() if none)
+template<typename Alphabet>
+size_t BasicBurstTrie<Alphabet>::seekEntry(const std::string& bucket, std::string_view key, bool& found) {
+    std::string_view entry;
+    for (size_t pos = 0; pos < bucket.size();) {
+        size_t next = readPacked(bucket, pos, entry);
+        int order = entry.compare(key);
+        if (order >= 0) {
+            found = order == 0;
+            return pos;
+        }
+        pos = next;
+    }
+    found = false;
+    return bucket.size();
+}
+
+template<typename Alphabet>
+TrieStats BasicBurstTrie<Alphabet>::stats() const {
+    TrieStats snapshot;
+    snapshot.memoryBytes = memoryBytes;
+    snapshot.nodes = nodeCount;
+    snapshot.words = wordCount;
+    snapshot.bursts = bursts.get();
+    snapshot.lookups = lookups.get();
+    snapshot.nodesVisited = nodesVisited.get();
+    return snapshot;
+}
+
+template<typename Alphabet>
+void BasicBurstTrie<Alphabet>::clear() {
+    root = std::make_unique<TrieNode>(false);
+    wordCount = 0;
+    nodeCount = 1;
+    memoryBytes = sizeof(TrieNode);
+    bursts.reset();
+    lookups.reset();
+    nodesVisited.reset();
+}
+
+template<typename Alphabet>
+std::vector<std::string> BasicBurstTrie<Alphabet>::getAllWords() const {
+    std::vector<std::string> words;
+    rangeScan("", "", [&words](const std::string& key) {
+        words.push_back(key);
+        return true;
+    });
+    return words;
+}
+
+// Explicit template instantiations
+template class BasicBurstTrie<ByteAlphabet>;
+template class BasicBurstTrie<LowercaseAlphabet>;
+template class BasicBurstTrie<DnaAlphabet>;
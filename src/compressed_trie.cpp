@@ -1,37 +1,45 @@
 #include "compressed_trie.h"
 #include <algorithm>
+#include <queue>
+#include <utility>
 
-CompressedTrie::CompressedTrie() : wordCount(0), nodeCount(1) {
+template<typename Alphabet>
+BasicCompressedTrie<Alphabet>::BasicCompressedTrie() : wordCount(0), nodeCount(1) {
     root = std::make_unique<TrieNode>();
+    memoryBytes = nodeBytes(root.get());
 }
 
-void CompressedTrie::insert(const std::string& word) {
-    if (word.empty()) return;
-    
+template<typename Alphabet>
+void BasicCompressedTrie<Alphabet>::insert(const std::string& word) {
+    if (word.empty() || !isValidKey<Alphabet>(word)) return;
+
     TrieNode* current = root.get();
     std::string remaining = word;
-    
+
     while (!remaining.empty()) {
-        char firstChar = remaining[0];
-        
+        int firstCode = Alphabet::toCode(remaining[0]);
+
         // Check if there's a child with this starting character
-        auto it = current->children.find(firstChar);
-        
-        if (it == current->children.end()) {
+        TrieNode* child = current->children.find(firstCode);
+
+        if (!child) {
             // No matching child - create new node with remaining string as edge label
             auto newNode = std::make_unique<TrieNode>();
             newNode->edgeLabel = remaining;
             newNode->isEndOfWord = true;
-            current->children[firstChar] = std::move(newNode);
+            size_t tableBytes = current->children.heapBytes();
+            memoryBytes += nodeBytes(newNode.get());
+            current->children.insert(firstCode, std::move(newNode));
+            memoryBytes += current->children.heapBytes() - tableBytes;
             nodeCount++;
             wordCount++;
+            addToCounts(word, 1);
             return;
         }
-        
+
         // Found a matching child
-        TrieNode* child = it->second.get();
-        int matchLen = matchingPrefixLength(remaining, child->edgeLabel);
-        
+        size_t matchLen = matchingPrefixLength(remaining, child->edgeLabel);
+
         if (matchLen == child->edgeLabel.length()) {
             // Full match of edge label
             if (matchLen == remaining.length()) {
@@ -39,6 +47,7 @@ void CompressedTrie::insert(const std::string& word) {
                 if (!child->isEndOfWord) {
                     child->isEndOfWord = true;
                     wordCount++;
+                    addToCounts(word, 1);
                 }
                 return;
             } else {
@@ -49,12 +58,13 @@ void CompressedTrie::insert(const std::string& word) {
         } else {
             // Partial match - need to split the edge
             splitNode(child, matchLen);
-            
+
             if (matchLen == remaining.length()) {
                 // The split point is our word ending
                 if (!child->isEndOfWord) {
                     child->isEndOfWord = true;
                     wordCount++;
+                    addToCounts(word, 1);
                 }
                 return;
             } else {
@@ -66,166 +76,562 @@ void CompressedTrie::insert(const std::string& word) {
     }
 }
 
-bool CompressedTrie::search(const std::string& word) const {
+template<typename Alphabet>
+bool BasicCompressedTrie<Alphabet>::search(const std::string& word) const {
     const TrieNode* current = root.get();
     std::string remaining = word;
-    
+    size_t visited = 0;
+    bool matched = true;
+
     while (!remaining.empty()) {
-        char firstChar = remaining[0];
-        auto it = current->children.find(firstChar);
-        
-        if (it == current->children.end()) {
-            return false;
+        const TrieNode* child = current->children.find(Alphabet::toCode(remaining[0]));
+
+        if (!child) {
+            matched = false;
+            break;
         }
-        
-        const TrieNode* child = it->second.get();
+
         const std::string& edgeLabel = child->edgeLabel;
-        
-        if (remaining.length() < edgeLabel.length()) {
-            return false;
-        }
-        
-        if (remaining.substr(0, edgeLabel.length()) != edgeLabel) {
-            return false;
+        visited++;
+
+        if (remaining.length() < edgeLabel.length() ||
+            remaining.compare(0, edgeLabel.length(), edgeLabel) != 0) {
+            matched = false;
+            break;
         }
-        
+
         remaining = remaining.substr(edgeLabel.length());
         current = child;
     }
-    
-    return current->isEndOfWord;
+
+    lookups.add(1);
+    nodesVisited.add(visited);
+    return matched && current->isEndOfWord;
 }
 
-bool CompressedTrie::startsWith(const std::string& prefix) const {
+template<typename Alphabet>
+bool BasicCompressedTrie<Alphabet>::startsWith(const std::string& prefix) const {
     const TrieNode* current = root.get();
     std::string remaining = prefix;
-    
+    size_t visited = 0;
+    bool matched = true;
+
     while (!remaining.empty()) {
-        char firstChar = remaining[0];
-        auto it = current->children.find(firstChar);
-        
-        if (it == current->children.end()) {
-            return false;
+        const TrieNode* child = current->children.find(Alphabet::toCode(remaining[0]));
+
+        if (!child) {
+            matched = false;
+            break;
         }
-        
-        const TrieNode* child = it->second.get();
+
         const std::string& edgeLabel = child->edgeLabel;
-        
-        int matchLen = matchingPrefixLength(remaining, edgeLabel);
-        
+        visited++;
+
+        size_t matchLen = matchingPrefixLength(remaining, edgeLabel);
+
         if (matchLen < std::min(remaining.length(), edgeLabel.length())) {
-            return false;
+            matched = false;
+            break;
         }
-        
+
+        current = child;
         if (remaining.length() <= edgeLabel.length()) {
-            return true;
+            break;
         }
-        
+
         remaining = remaining.substr(edgeLabel.length());
-        current = child;
     }
-    
-    return true;
+
+    lookups.add(1);
+    nodesVisited.add(visited);
+    // remove() leaves emptied nodes in place
+    return matched && current->wordsBelow > 0;
 }
 
-bool CompressedTrie::remove(const std::string& word) {
-    if (!search(word)) {
+template<typename Alphabet>
+bool BasicCompressedTrie<Alphabet>::remove(const std::string& word) {
+    // Walked here instead of through search(), which would count a lookup
+    TrieNode* current = root.get();
+    size_t pos = 0;
+
+    while (pos < word.size()) {
+        current = current->children.find(Alphabet::toCode(word[pos]));
+        if (!current || word.compare(pos, current->edgeLabel.size(), current->edgeLabel) != 0) {
+            return false;
+        }
+        pos += current->edgeLabel.size();
+    }
+
+    if (!current->isEndOfWord) {
         return false;
     }
-    
+
     // Simplified removal - just unmark end of word
     // Full removal with node merging would be more complex
-    const TrieNode* current = root.get();
-    std::string remaining = word;
-    
-    while (!remaining.empty()) {
-        char firstChar = remaining[0];
-        auto it = current->children.find(firstChar);
-        current = it->second.get();
-        remaining = remaining.substr(current->edgeLabel.length());
-    }
-    
-    // Cast away const for modification (in real implementation, we'd track the path)
-    const_cast<TrieNode*>(current)->isEndOfWord = false;
+    current->isEndOfWord = false;
     wordCount--;
+    addToCounts(word, -1);
     return true;
 }
 
-size_t CompressedTrie::getMemoryUsage() const {
-    return calculateMemoryUsage(root.get());
+// Adjusts wordsBelow on every node from the root to the node where key
+// ends, which must exist
+template<typename Alphabet>
+void BasicCompressedTrie<Alphabet>::addToCounts(const std::string& key, int delta) {
+    TrieNode* current = root.get();
+    current->wordsBelow += delta;
+    for (size_t pos = 0; pos < key.size(); pos += current->edgeLabel.size()) {
+        current = current->children.find(Alphabet::toCode(key[pos]));
+        current->wordsBelow += delta;
+    }
+}
+
+template<typename Alphabet>
+size_t BasicCompressedTrie<Alphabet>::longestPrefixMatch(std::string_view input) const {
+    const TrieNode* current = root.get();
+    size_t pos = 0;
+    size_t longest = 0;
+
+    while (pos < input.size()) {
+        current = current->children.find(Alphabet::toCode(input[pos]));
+        if (!current) {
+            break;
+        }
+
+        const std::string& label = current->edgeLabel;
+        if (input.size() - pos < label.size() || input.compare(pos, label.size(), label) != 0) {
+            break;
+        }
+
+        pos += label.size();
+        if (current->isEndOfWord) {
+            longest = pos;
+        }
+    }
+
+    return longest;
+}
+
+template<typename Alphabet>
+void BasicCompressedTrie<Alphabet>::rangeScan(const std::string& lo, const std::string& hi,
+                                              const KeyCallback& onKey) const {
+    std::string word;
+    rangeScanHelper(root.get(), true, lo, hi, word, onKey);
+}
+
+// tight: word is still a prefix of lo. A child's whole label is compared
+// against lo, so a subtree is either skipped, entered tight, or known to
+// be entirely above lo. Returns false once the scan is over.
+template<typename Alphabet>
+bool BasicCompressedTrie<Alphabet>::rangeScanHelper(const TrieNode* node, bool tight, const std::string& lo,
+                                                    const std::string& hi, std::string& word,
+                                                    const KeyCallback& onKey) const {
+    if (!hi.empty() && word >= hi) {
+        return false;
+    }
+
+    size_t depth = word.size();
+    if (tight && depth == lo.size()) {
+        tight = false;
+    }
+
+    if (!tight && node->isEndOfWord && !onKey(word)) {
+        return false;
+    }
+
+    int firstCode = tight ? lowerBoundCode<Alphabet>(lo[depth]) : 0;
+
+    return node->children.forEachFrom(firstCode, [&](int, const TrieNode* child) {
+        const std::string& label = child->edgeLabel;
+        bool childTight = false;
+
+        if (tight) {
+            size_t m = 0;
+            while (m < label.size() && depth + m < lo.size() && label[m] == lo[depth + m]) {
+                m++;
+            }
+            if (m == label.size()) {
+                childTight = true;
+            } else if (depth + m < lo.size() &&
+                       static_cast<unsigned char>(label[m]) < static_cast<unsigned char>(lo[depth + m])) {
+                return true;  // whole subtree sorts before lo
+            }
+        }
+
+        word += label;
+        bool more = rangeScanHelper(child, childTight, lo, hi, word, onKey);
+        word.resize(depth);
+        return more;
+    });
+}
+
+// The prefix may end inside an edge label; the node below that edge holds
+// exactly the keys that extend the prefix
+template<typename Alphabet>
+size_t BasicCompressedTrie<Alphabet>::countPrefix(const std::string& prefix) const {
+    const TrieNode* current = root.get();
+    size_t pos = 0;
+
+    while (pos < prefix.size()) {
+        current = current->children.find(Alphabet::toCode(prefix[pos]));
+        if (!current) {
+            return 0;
+        }
+
+        const std::string& label = current->edgeLabel;
+        size_t length = std::min(label.size(), prefix.size() - pos);
+        if (prefix.compare(pos, length, label, 0, length) != 0) {
+            return 0;
+        }
+        pos += label.size();
+    }
+
+    return current->wordsBelow;
+}
+
+// Walks down key; every key ending on the way (a proper prefix of key)
+// and every subtree whose label sorts before key's next characters is
+// smaller. Stops where key leaves the trie.
+template<typename Alphabet>
+size_t BasicCompressedTrie<Alphabet>::rank(const std::string& key) const {
+    const TrieNode* current = root.get();
+    size_t below = 0;
+    size_t pos = 0;
+
+    while (pos < key.size()) {
+        if (current->isEndOfWord) {
+            below++;
+        }
+
+        unsigned char c = static_cast<unsigned char>(key[pos]);
+        const TrieNode* next = nullptr;
+        current->children.forEachFrom(0, [&](int, const TrieNode* child) {
+            const std::string& label = child->edgeLabel;
+            if (static_cast<unsigned char>(label[0]) < c) {
+                below += child->wordsBelow;
+                return true;
+            }
+            if (static_cast<unsigned char>(label[0]) == c) {
+                size_t m = matchingPrefixLength(label, key.substr(pos, label.size()));
+                if (m == label.size()) {
+                    next = child;
+                } else if (pos + m < key.size() &&
+                           static_cast<unsigned char>(label[m]) < static_cast<unsigned char>(key[pos + m])) {
+                    below += child->wordsBelow;  // whole subtree sorts before key
+                }
+            }
+            return false;
+        });
+
+        if (!next) {
+            return below;
+        }
+        pos += next->edgeLabel.size();
+        current = next;
+    }
+
+    return below;
+}
+
+template<typename Alphabet>
+std::string BasicCompressedTrie<Alphabet>::select(size_t index) const {
+    if (index >= wordCount) {
+        return "";
+    }
+
+    const TrieNode* current = root.get();
+    std::string word;
+
+    while (true) {
+        if (current->isEndOfWord) {
+            if (index == 0) {
+                return word;
+            }
+            index--;
+        }
+
+        current->children.forEachFrom(0, [&](int, const TrieNode* child) {
+            if (index < child->wordsBelow) {
+                word += child->edgeLabel;
+                current = child;
+                return false;
+            }
+            index -= child->wordsBelow;
+            return true;
+        });
+    }
 }
 
-size_t CompressedTrie::calculateMemoryUsage(const TrieNode* node) const {
-    if (!node) return 0;
-    
-    size_t total = sizeof(TrieNode);
-    total += node->edgeLabel.capacity();
-    total += node->children.size() * (sizeof(char) + sizeof(std::unique_ptr<TrieNode>));
-    
-    for (const auto& [c, child] : node->children) {
-        total += calculateMemoryUsage(child.get());
+template<typename Alphabet>
+std::vector<FuzzyMatch> BasicCompressedTrie<Alphabet>::fuzzySearch(const std::string& query,
+                                                                   int maxDistance) const {
+    std::vector<FuzzyMatch> matches;
+    LevenshteinAutomaton automaton(query, maxDistance);
+
+    std::vector<int> rows(automaton.rowSize());
+    automaton.start(rows.data());
+
+    std::string word;
+    fuzzySearchHelper(root.get(), automaton, rows, word, matches);
+    return matches;
+}
+
+template<typename Alphabet>
+void BasicCompressedTrie<Alphabet>::fuzzySearchHelper(const TrieNode* node, const LevenshteinAutomaton& automaton,
+                                                      std::vector<int>& rows, std::string& word,
+                                                      std::vector<FuzzyMatch>& matches) const {
+    size_t rowSize = automaton.rowSize();
+    size_t depth = word.size();
+
+    if (node->isEndOfWord && automaton.isMatch(&rows[depth * rowSize])) {
+        matches.push_back({word, automaton.distance(&rows[depth * rowSize])});
+    }
+
+    node->children.forEach([&](int, const TrieNode* child) {
+        const std::string& label = child->edgeLabel;
+        if (rows.size() < (depth + label.size() + 1) * rowSize) {
+            rows.resize((depth + label.size() + 1) * rowSize);
+        }
+
+        // consume the edge one character at a time
+        for (size_t i = 0; i < label.size(); i++) {
+            size_t d = depth + i;
+            int rowMin = automaton.step(&rows[d * rowSize], &rows[(d + 1) * rowSize], label[i], d + 1);
+            if (automaton.isDead(rowMin)) {
+                return;
+            }
+        }
+
+        word += label;
+        fuzzySearchHelper(child, automaton, rows, word, matches);
+        word.resize(depth);
+    });
+}
+
+template<typename Alphabet>
+std::vector<std::string> BasicCompressedTrie<Alphabet>::matchPattern(const std::string& pattern) const {
+    std::vector<std::string> matches;
+    GlobPattern glob(pattern);
+
+    std::vector<uint64_t> states(glob.stateWords());
+    glob.start(states.data());
+
+    std::string word;
+    matchPatternHelper(root.get(), glob, states, word, matches);
+    return matches;
+}
+
+template<typename Alphabet>
+void BasicCompressedTrie<Alphabet>::matchPatternHelper(const TrieNode* node, const GlobPattern& glob,
+                                                       std::vector<uint64_t>& states, std::string& word,
+                                                       std::vector<std::string>& matches) const {
+    size_t width = glob.stateWords();
+    size_t depth = word.size();
+
+    if (node->isEndOfWord && glob.isMatch(&states[depth * width])) {
+        matches.push_back(word);
+    }
+
+    int forced = glob.forcedChar(&states[depth * width]);
+    if (forced == GlobPattern::NO_CHAR) {
+        return;
+    }
+
+    auto visit = [&](const TrieNode* child) {
+        const std::string& label = child->edgeLabel;
+        if (states.size() < (depth + label.size() + 1) * width) {
+            states.resize((depth + label.size() + 1) * width);
+        }
+
+        for (size_t i = 0; i < label.size(); i++) {
+            size_t d = depth + i;
+            if (!glob.step(&states[d * width], &states[(d + 1) * width], label[i])) {
+                return;
+            }
+        }
+
+        word += label;
+        matchPatternHelper(child, glob, states, word, matches);
+        word.resize(depth);
+    };
+
+    if (forced != GlobPattern::ANY_CHAR) {
+        const TrieNode* child = node->children.find(Alphabet::toCode(static_cast<char>(forced)));
+        if (child) {
+            visit(child);
+        }
+        return;
     }
-    
-    return total;
+
+    node->children.forEach([&](int, const TrieNode* child) {
+        visit(child);
+    });
+}
+
+template<typename Alphabet>
+TrieStats BasicCompressedTrie<Alphabet>::stats() const {
+    TrieStats snapshot;
+    snapshot.memoryBytes = memoryBytes;
+    snapshot.nodes = nodeCount;
+    snapshot.words = wordCount;
+    snapshot.splits = splits.get();
+    snapshot.lookups = lookups.get();
+    snapshot.nodesVisited = nodesVisited.get();
+    return snapshot;
 }
 
-double CompressedTrie::getCompressionRatio() const {
+// What one node accounts for: itself, its label's heap buffer and its
+// child array. Labels short enough for the small-string buffer live
+// inside the TrieNode and cost nothing extra.
+template<typename Alphabet>
+size_t BasicCompressedTrie<Alphabet>::nodeBytes(const TrieNode* node) {
+    static const size_t inlineCapacity = std::string().capacity();
+    size_t capacity = node->edgeLabel.capacity();
+    size_t labelBytes = capacity > inlineCapacity ? capacity + 1 : 0;
+    return sizeof(TrieNode) + labelBytes + node->children.heapBytes();
+}
+
+template<typename Alphabet>
+double BasicCompressedTrie<Alphabet>::getCompressionRatio() const {
     // Estimate: compared to standard trie with same words
     // This would need actual comparison in benchmarks
     return static_cast<double>(getMemoryUsage()) / (wordCount * 50.0); // rough estimate
 }
 
-void CompressedTrie::clear() {
+// The first character of each child's label goes into the parent's
+// block; the rest of the label is placed right away as a chain of
+// single-code blocks ending at the child's own state.
+template<typename Alphabet>
+BasicDoubleArrayTrie<Alphabet> BasicCompressedTrie<Alphabet>::freeze() const {
+    BasicDoubleArrayTrie<Alphabet> frozen;
+    std::queue<std::pair<const TrieNode*, int>> pending;  // node and the state at the end of its label
+    pending.push({root.get(), 0});
+    std::vector<int> codes;
+    std::vector<int> link(1);
+
+    while (!pending.empty()) {
+        auto [node, state] = pending.front();
+        pending.pop();
+
+        codes.clear();
+        node->children.forEach([&codes](int code, const TrieNode* child) {
+            if (child->wordsBelow > 0) {
+                codes.push_back(code);
+            }
+        });
+
+        if (!codes.empty()) {
+            int childBase = frozen.placeChildren(state, codes);
+            node->children.forEach([&](int code, const TrieNode* child) {
+                if (child->wordsBelow == 0) {
+                    return;
+                }
+
+                int next = childBase + code;
+                for (size_t i = 1; i < child->edgeLabel.size(); i++) {
+                    link[0] = Alphabet::toCode(child->edgeLabel[i]);
+                    next = frozen.placeChildren(next, link) + link[0];
+                }
+                pending.push({child, next});
+            });
+        }
+
+        if (node->isEndOfWord && state != 0) {
+            frozen.markEndOfWord(state);
+        }
+    }
+
+    frozen.compact();
+    return frozen;
+}
+
+template<typename Alphabet>
+BasicFlatTrie<Alphabet> BasicCompressedTrie<Alphabet>::relayout() const {
+    BasicFlatTrie<Alphabet> flat;
+    flat.build(root.get(), [](const void* source, auto& out) {
+        const TrieNode* node = static_cast<const TrieNode*>(source);
+        out.label = node->edgeLabel.empty() ? std::string_view() : std::string_view(node->edgeLabel).substr(1);
+        out.isEndOfWord = node->isEndOfWord;
+        node->children.forEach([&out](int code, const TrieNode* child) {
+            if (child->wordsBelow > 0) {
+                out.children.push_back({code, child});
+            }
+        });
+    });
+    return flat;
+}
+
+template<typename Alphabet>
+void BasicCompressedTrie<Alphabet>::clear() {
     root = std::make_unique<TrieNode>();
     wordCount = 0;
     nodeCount = 1;
+    memoryBytes = nodeBytes(root.get());
+    splits.reset();
+    lookups.reset();
+    nodesVisited.reset();
 }
 
-std::vector<std::string> CompressedTrie::getAllWords() const {
+template<typename Alphabet>
+std::vector<std::string> BasicCompressedTrie<Alphabet>::getAllWords() const {
     std::vector<std::string> words;
     getAllWordsHelper(root.get(), "", words);
     return words;
 }
 
-void CompressedTrie::getAllWordsHelper(const TrieNode* node, std::string currentWord, 
-                                       std::vector<std::string>& words) const {
+template<typename Alphabet>
+void BasicCompressedTrie<Alphabet>::getAllWordsHelper(const TrieNode* node, std::string currentWord,
+                                                      std::vector<std::string>& words) const {
     if (!node) return;
-    
+
     currentWord += node->edgeLabel;
-    
+
     if (node->isEndOfWord) {
         words.push_back(currentWord);
     }
-    
-    for (const auto& [c, child] : node->children) {
-        getAllWordsHelper(child.get(), currentWord, words);
-    }
+
+    node->children.forEach([&](int, const TrieNode* child) {
+        getAllWordsHelper(child, currentWord, words);
+    });
 }
 
-int CompressedTrie::matchingPrefixLength(const std::string& str1, const std::string& str2) const {
-    int len = 0;
-    int maxLen = std::min(str1.length(), str2.length());
-    
+template<typename Alphabet>
+size_t BasicCompressedTrie<Alphabet>::matchingPrefixLength(const std::string& str1,
+                                                           const std::string& str2) const {
+    size_t len = 0;
+    size_t maxLen = std::min(str1.length(), str2.length());
+
     while (len < maxLen && str1[len] == str2[len]) {
         len++;
     }
-    
+
     return len;
 }
 
-void CompressedTrie::splitNode(TrieNode* node, int splitPos) {
+template<typename Alphabet>
+void BasicCompressedTrie<Alphabet>::splitNode(TrieNode* node, size_t splitPos) {
+    size_t before = nodeBytes(node);
+
     // Create new child node with the suffix
     auto newChild = std::make_unique<TrieNode>();
     newChild->edgeLabel = node->edgeLabel.substr(splitPos);
     newChild->isEndOfWord = node->isEndOfWord;
+    newChild->wordsBelow = node->wordsBelow;
     newChild->children = std::move(node->children);
-    
+
     // Update current node
-    char nextChar = newChild->edgeLabel[0];
+    int nextCode = Alphabet::toCode(newChild->edgeLabel[0]);
     node->edgeLabel = node->edgeLabel.substr(0, splitPos);
     node->isEndOfWord = false;
     node->children.clear();
-    node->children[nextChar] = std::move(newChild);
-    
+    const TrieNode* child = node->children.insert(nextCode, std::move(newChild));
+
     nodeCount++;
+    memoryBytes += nodeBytes(node) + nodeBytes(child) - before;
+    splits.add(1);
 }
+
+// Explicit template instantiations
+template class BasicCompressedTrie<ByteAlphabet>;
+template class BasicCompressedTrie<LowercaseAlphabet>;
+template class BasicCompressedTrie<DnaAlphabet>;
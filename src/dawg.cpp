@@ -0,0 +1,322 @@
+#include "dawg.h"
+#include <algorithm>
+
+template<typename Alphabet>
+BasicDawg<Alphabet>::BasicDawg() : sealed(false), wordCount(0) {
+    building.emplace_back();
+    path.push_back(0);
+}
+
+template<typename Alphabet>
+void BasicDawg<Alphabet>::insert(const std::string& word) {
+    if (sealed || !isValidKey<Alphabet>(word) || (wordCount > 0 && word <= previous)) return;
+
+    size_t common = 0;
+    while (common < previous.size() && common < word.size() && previous[common] == word[common]) {
+        common++;
+    }
+
+    // Nothing below the shared prefix can gain edges any more
+    minimize(common);
+
+    for (size_t i = common; i < word.size(); i++) {
+        uint32_t state = newState();
+        building[path.back()].edges.push_back({static_cast<uint8_t>(Alphabet::toCode(word[i])), state});
+        path.push_back(state);
+    }
+
+    building[path.back()].isFinal = true;
+    previous = word;
+    wordCount++;
+}
+
+// Replaces each state on the previous key's path below depth by an
+// equivalent one from the register, or registers it. Deepest first, so
+// a state's children are already canonical when it is compared.
+template<typename Alphabet>
+void BasicDawg<Alphabet>::minimize(size_t depth) {
+    while (path.size() > depth + 1) {
+        uint32_t child = path.back();
+        path.pop_back();
+
+        size_t hash = hashState(child);
+        uint32_t existing = NO_STATE;
+        auto [first, last] = registry.equal_range(hash);
+        for (auto it = first; it != last; ++it) {
+            if (sameState(it->second, child)) {
+                existing = it->second;
+                break;
+            }
+        }
+
+        if (existing == NO_STATE) {
+            registry.emplace(hash, child);
+        } else {
+            building[path.back()].edges.back().second = existing;
+            building[child] = BuildState();
+            recycled.push_back(child);
+        }
+    }
+}
+
+template<typename Alphabet>
+uint32_t BasicDawg<Alphabet>::newState() {
+    if (!recycled.empty()) {
+        uint32_t id = recycled.back();
+        recycled.pop_back();
+        return id;
+    }
+    building.emplace_back();
+    return static_cast<uint32_t>(building.size() - 1);
+}
+
+template<typename Alphabet>
+size_t BasicDawg<Alphabet>::hashState(uint32_t id) const {
+    const BuildState& state = building[id];
+    size_t hash = state.isFinal ? 0x9e3779b97f4a7c15ULL : 0;
+    for (const auto& [code, target] : state.edges) {
+        hash = (hash ^ (static_cast<size_t>(target) << 8 | code)) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+template<typename Alphabet>
+bool BasicDawg<Alphabet>::sameState(uint32_t a, uint32_t b) const {
+    return building[a].isFinal == building[b].isFinal && building[a].edges == building[b].edges;
+}
+
+// Packs the states breadth first from the root into the edge arrays and
+// drops everything only the construction needed
+template<typename Alphabet>
+void BasicDawg<Alphabet>::build() {
+    if (sealed) return;
+    minimize(0);
+
+    std::vector<uint32_t> remap(building.size(), NO_STATE);
+    std::vector<uint32_t> order{0};
+    remap[0] = 0;
+    size_t edgeCount = 0;
+
+    for (size_t i = 0; i < order.size(); i++) {
+        for (const auto& edge : building[order[i]].edges) {
+            if (remap[edge.second] == NO_STATE) {
+                remap[edge.second] = static_cast<uint32_t>(order.size());
+                order.push_back(edge.second);
+            }
+        }
+        edgeCount += building[order[i]].edges.size();
+    }
+
+    firstEdge.reserve(order.size() + 1);
+    edgeCodes.reserve(edgeCount);
+    edgeTargets.reserve(edgeCount);
+    finalStates.resize(order.size());
+
+    for (size_t i = 0; i < order.size(); i++) {
+        const BuildState& state = building[order[i]];
+        firstEdge.push_back(static_cast<uint32_t>(edgeCodes.size()));
+        finalStates[i] = state.isFinal;
+        for (const auto& [code, target] : state.edges) {
+            edgeCodes.push_back(code);
+            edgeTargets.push_back(remap[target]);
+        }
+    }
+    firstEdge.push_back(static_cast<uint32_t>(edgeCodes.size()));
+
+    std::vector<BuildState>().swap(building);
+    std::vector<uint32_t>().swap(recycled);
+    decltype(registry)().swap(registry);
+    std::vector<uint32_t>().swap(path);
+    std::string().swap(previous);
+    sealed = true;
+}
+
+template<typename Alphabet>
+uint32_t BasicDawg<Alphabet>::step(uint32_t state, int code) const {
+    if (code < 0) {
+        return NO_STATE;
+    }
+
+    uint32_t begin = firstEdge[state];
+    uint32_t end = firstEdge[state + 1];
+    uint32_t i = begin;
+
+    if (end - begin <= LINEAR_SEARCH_MAX) {
+        while (i < end && edgeCodes[i] < code) {
+            i++;
+        }
+    } else {
+        i = std::lower_bound(edgeCodes.begin() + begin, edgeCodes.begin() + end, code) - edgeCodes.begin();
+    }
+
+    return i < end && edgeCodes[i] == code ? edgeTargets[i] : NO_STATE;
+}
+
+template<typename Alphabet>
+bool BasicDawg<Alphabet>::search(const std::string& word) const {
+    if (!sealed) return false;
+
+    uint32_t state = 0;
+    size_t visited = 0;
+
+    for (char c : word) {
+        state = step(state, Alphabet::toCode(c));
+        if (state == NO_STATE) {
+            break;
+        }
+        visited++;
+    }
+
+    lookups.add(1);
+    nodesVisited.add(visited);
+    return state != NO_STATE && finalStates[state];
+}
+
+template<typename Alphabet>
+bool BasicDawg<Alphabet>::startsWith(const std::string& prefix) const {
+    if (!sealed) return false;
+
+    uint32_t state = 0;
+    size_t visited = 0;
+
+    for (char c : prefix) {
+        state = step(state, Alphabet::toCode(c));
+        if (state == NO_STATE) {
+            break;
+        }
+        visited++;
+    }
+
+    lookups.add(1);
+    nodesVisited.add(visited);
+    return state != NO_STATE;
+}
+
+template<typename Alphabet>
+size_t BasicDawg<Alphabet>::longestPrefixMatch(std::string_view input) const {
+    if (!sealed) return 0;
+
+    uint32_t state = 0;
+    size_t longest = 0;
+
+    for (size_t i = 0; i < input.size(); i++) {
+        state = step(state, Alphabet::toCode(input[i]));
+        if (state == NO_STATE) {
+            break;
+        }
+        if (finalStates[state]) {
+            longest = i + 1;
+        }
+    }
+
+    return longest;
+}
+
+template<typename Alphabet>
+void BasicDawg<Alphabet>::rangeScan(const std::string& lo, const std::string& hi,
+                                    const KeyCallback& onKey) const {
+    if (!sealed) return;
+
+    std::string word;
+    rangeScanHelper(0, true, lo, hi, word, onKey);
+}
+
+// tight: word is still a prefix of lo, so codes below lo[depth] are
+// skipped. Shared states are simply walked once per path into them.
+// Returns false once the scan is over.
+template<typename Alphabet>
+bool BasicDawg<Alphabet>::rangeScanHelper(uint32_t state, bool tight, const std::string& lo,
+                                          const std::string& hi, std::string& word,
+                                          const KeyCallback& onKey) const {
+    if (!hi.empty() && word >= hi) {
+        return false;
+    }
+
+    size_t depth = word.size();
+    if (tight && depth == lo.size()) {
+        tight = false;
+    }
+
+    if (!tight && finalStates[state] && !onKey(word)) {
+        return false;
+    }
+
+    int loCode = tight ? Alphabet::toCode(lo[depth]) : -1;
+    int firstCode = tight ? lowerBoundCode<Alphabet>(lo[depth]) : 0;
+
+    for (uint32_t i = firstEdge[state]; i < firstEdge[state + 1]; i++) {
+        int code = edgeCodes[i];
+        if (code < firstCode) {
+            continue;
+        }
+
+        word.push_back(Alphabet::toChar(code));
+        bool more = rangeScanHelper(edgeTargets[i], code == loCode, lo, hi, word, onKey);
+        word.pop_back();
+        if (!more) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Alphabet>
+size_t BasicDawg<Alphabet>::getMemoryUsage() const {
+    if (sealed) {
+        return firstEdge.capacity() * sizeof(uint32_t) + edgeCodes.capacity() +
+               edgeTargets.capacity() * sizeof(uint32_t) + finalStates.capacity() / 8;
+    }
+
+    size_t bytes = building.capacity() * sizeof(BuildState) + recycled.capacity() * sizeof(uint32_t) +
+                   registry.size() * (sizeof(size_t) + sizeof(uint32_t) + 2 * sizeof(void*)) +
+                   registry.bucket_count() * sizeof(void*);
+    for (const auto& state : building) {
+        bytes += state.edges.capacity() * sizeof(state.edges[0]);
+    }
+    return bytes;
+}
+
+template<typename Alphabet>
+TrieStats BasicDawg<Alphabet>::stats() const {
+    TrieStats snapshot;
+    snapshot.memoryBytes = getMemoryUsage();
+    snapshot.nodes = getNodeCount();
+    snapshot.words = wordCount;
+    snapshot.lookups = lookups.get();
+    snapshot.nodesVisited = nodesVisited.get();
+    return snapshot;
+}
+
+template<typename Alphabet>
+void BasicDawg<Alphabet>::clear() {
+    building.assign(1, BuildState());
+    recycled.clear();
+    registry.clear();
+    path.assign(1, 0);
+    previous.clear();
+    sealed = false;
+
+    std::vector<uint32_t>().swap(firstEdge);
+    std::vector<uint8_t>().swap(edgeCodes);
+    std::vector<uint32_t>().swap(edgeTargets);
+    std::vector<bool>().swap(finalStates);
+
+    wordCount = 0;
+    lookups.reset();
+    nodesVisited.reset();
+}
+
+template<typename Alphabet>
+std::vector<std::string> BasicDawg<Alphabet>::getAllWords() const {
+    std::vector<std::string> words;
+    rangeScan("", "", [&words](const std::string& key) {
+        words.push_back(key);
+        return true;
+    });
+    return words;
+}
+
+// Explicit template instantiations
+template class BasicDawg<ByteAlphabet>;
+template class BasicDawg<LowercaseAlphabet>;
+template class BasicDawg<DnaAlphabet>;
@@ -1,83 +1,34 @@
 #include "double_array_trie.h"
 #include <algorithm>
-#include <climits>
-
-DoubleArrayTrie::DoubleArrayTrie() : wordCount(0), maxState(0) {
-    base.resize(INITIAL_SIZE, EMPTY);
-    check.resize(INITIAL_SIZE, EMPTY);
-    used.resize(INITIAL_SIZE, false);
-    
-    // Initialize root
+
+template<typename Alphabet>
+BasicDoubleArrayTrie<Alphabet>::BasicDoubleArrayTrie()
+    : wordCount(0), stateCount(1), maxState(0), freeHead(EMPTY) {
+    resize(INITIAL_SIZE);
+
+    // Initialize root (its own parent, so the slot never looks free)
+    unlinkFree(0);
     base[0] = 1;
-    check[0] = EMPTY;
-    used[0] = true;
+    check[0] = 0;
 }
 
-void DoubleArrayTrie::insert(const std::string& word) {
-    if (word.empty()) return;
-    
+template<typename Alphabet>
+void BasicDoubleArrayTrie<Alphabet>::insert(const std::string& word) {
+    if (word.empty() || !isValidKey<Alphabet>(word)) return;
+
     int state = 0;  // Start from root
-    
-    for (size_t i = 0; i < word.length(); i++) {
-        char c = word[i];
-        int code = static_cast<unsigned char>(c);
-        
-        int nextState = getTransition(state, c);
-        
+
+    for (char c : word) {
+        int code = Alphabet::toCode(c);
+        int nextState = getTransition(state, code);
+
         if (nextState == EMPTY) {
-            // Need to create new transition
-            std::unordered_set<char> chars;
-            chars.insert(c);
-            
-            // For existing children, collect their characters
-            for (int ch = 0; ch < 256; ch++) {
-                int existing = base[state] + ch;
-                if (existing >= 0 && existing < static_cast<int>(base.size()) && 
-                    check[existing] == state) {
-                    chars.insert(static_cast<char>(ch));
-                }
-            }
-            
-            // Find new base value that accommodates all characters
-            int newBase = findBase(state, chars);
-            
-            if (newBase != base[state] && base[state] != EMPTY) {
-                // Need to relocate existing children
-                for (int ch = 0; ch < 256; ch++) {
-                    int oldNext = base[state] + ch;
-                    if (oldNext >= 0 && oldNext < static_cast<int>(base.size()) && 
-                        check[oldNext] == state) {
-                        
-                        int newNext = newBase + ch;
-                        if (newNext >= static_cast<int>(base.size())) {
-                            resize(newNext + 1000);
-                        }
-                        
-                        base[newNext] = base[oldNext];
-                        check[newNext] = state;
-                        used[newNext] = true;
-                        
-                        used[oldNext] = false;
-                        base[oldNext] = EMPTY;
-                        check[oldNext] = EMPTY;
-                    }
-                }
-            }
-            
-            base[state] = newBase;
-            nextState = newBase + code;
-            
-            if (nextState >= static_cast<int>(base.size())) {
-                resize(nextState + 1000);
-            }
-            
-            setTransition(state, c, nextState);
-            maxState = std::max(maxState, static_cast<size_t>(nextState));
+            nextState = addTransition(state, code);
         }
-        
+
         state = nextState;
     }
-    
+
     // Mark end of word (use negative base value)
     if (base[state] >= 0) {
         base[state] = -base[state] - 1;  // Negative indicates end of word
@@ -85,136 +36,524 @@ void DoubleArrayTrie::insert(const std::string& word) {
     }
 }
 
-bool DoubleArrayTrie::search(const std::string& word) const {
+template<typename Alphabet>
+bool BasicDoubleArrayTrie<Alphabet>::search(const std::string& word) const {
     int state = 0;
-    
+    size_t visited = 0;
+
     for (char c : word) {
-        int nextState = getTransition(state, c);
-        if (nextState == EMPTY) {
-            return false;
+        state = getTransition(state, Alphabet::toCode(c));
+        if (state == EMPTY) {
+            break;
         }
-        state = nextState;
+        visited++;
     }
-    
-    return base[state] < 0;  // Negative base means end of word
+
+    lookups.add(1);
+    nodesVisited.add(visited);
+    return state != EMPTY && base[state] < 0;  // Negative base means end of word
 }
 
-bool DoubleArrayTrie::startsWith(const std::string& prefix) const {
+template<typename Alphabet>
+bool BasicDoubleArrayTrie<Alphabet>::startsWith(const std::string& prefix) const {
     int state = 0;
-    
+    size_t visited = 0;
+
     for (char c : prefix) {
-        int nextState = getTransition(state, c);
+        state = getTransition(state, Alphabet::toCode(c));
+        if (state == EMPTY) {
+            break;
+        }
+        visited++;
+    }
+
+    lookups.add(1);
+    nodesVisited.add(visited);
+    return state != EMPTY;
+}
+
+template<typename Alphabet>
+size_t BasicDoubleArrayTrie<Alphabet>::longestPrefixMatch(std::string_view input) const {
+    int state = 0;
+    size_t longest = 0;
+
+    for (size_t i = 0; i < input.size(); i++) {
+        state = getTransition(state, Alphabet::toCode(input[i]));
+        if (state == EMPTY) {
+            break;
+        }
+        if (base[state] < 0) {
+            longest = i + 1;
+        }
+    }
+
+    return longest;
+}
+
+template<typename Alphabet>
+void BasicDoubleArrayTrie<Alphabet>::rangeScan(const std::string& lo, const std::string& hi,
+                                               const KeyCallback& onKey) const {
+    std::string word;
+    rangeScanHelper(0, true, lo, hi, word, onKey);
+}
+
+// tight: word is still a prefix of lo, so codes below lo[depth] are
+// skipped. Returns false once the scan is over.
+template<typename Alphabet>
+bool BasicDoubleArrayTrie<Alphabet>::rangeScanHelper(int state, bool tight, const std::string& lo,
+                                                     const std::string& hi, std::string& word,
+                                                     const KeyCallback& onKey) const {
+    if (!hi.empty() && word >= hi) {
+        return false;
+    }
+
+    size_t depth = word.size();
+    if (tight && depth == lo.size()) {
+        tight = false;
+    }
+
+    if (!tight && base[state] < 0 && !onKey(word)) {
+        return false;
+    }
+
+    int loCode = tight ? Alphabet::toCode(lo[depth]) : -1;
+    int firstCode = tight ? lowerBoundCode<Alphabet>(lo[depth]) : 0;
+
+    for (int code = firstCode; code < Alphabet::size; code++) {
+        int nextState = getTransition(state, code);
         if (nextState == EMPTY) {
+            continue;
+        }
+
+        word.push_back(Alphabet::toChar(code));
+        bool more = rangeScanHelper(nextState, code == loCode, lo, hi, word, onKey);
+        word.pop_back();
+        if (!more) {
             return false;
         }
-        state = nextState;
     }
-    
+
     return true;
 }
 
-size_t DoubleArrayTrie::getMemoryUsage() const {
-    return base.size() * sizeof(int) + check.size() * sizeof(int) + 
-           used.size() * sizeof(bool);
+template<typename Alphabet>
+std::vector<FuzzyMatch> BasicDoubleArrayTrie<Alphabet>::fuzzySearch(const std::string& query,
+                                                                    int maxDistance) const {
+    std::vector<FuzzyMatch> matches;
+    LevenshteinAutomaton automaton(query, maxDistance);
+
+    std::vector<int> rows(automaton.rowSize());
+    automaton.start(rows.data());
+
+    std::string word;
+    fuzzySearchHelper(0, automaton, rows, word, matches);
+    return matches;
 }
 
-double DoubleArrayTrie::getSpaceEfficiency() const {
-    if (base.size() == 0) return 0.0;
-    
-    size_t usedCount = 0;
-    for (bool u : used) {
-        if (u) usedCount++;
+template<typename Alphabet>
+void BasicDoubleArrayTrie<Alphabet>::fuzzySearchHelper(int state, const LevenshteinAutomaton& automaton,
+                                                       std::vector<int>& rows, std::string& word,
+                                                       std::vector<FuzzyMatch>& matches) const {
+    size_t rowSize = automaton.rowSize();
+    size_t depth = word.size();
+
+    if (base[state] < 0 && automaton.isMatch(&rows[depth * rowSize])) {
+        matches.push_back({word, automaton.distance(&rows[depth * rowSize])});
+    }
+
+    if (rows.size() < (depth + 2) * rowSize) {
+        rows.resize((depth + 2) * rowSize);
+    }
+
+    for (int code = 0; code < Alphabet::size; code++) {
+        int nextState = getTransition(state, code);
+        if (nextState == EMPTY) {
+            continue;
+        }
+
+        char c = Alphabet::toChar(code);
+        int rowMin = automaton.step(&rows[depth * rowSize], &rows[(depth + 1) * rowSize], c, depth + 1);
+        if (automaton.isDead(rowMin)) {
+            continue;
+        }
+
+        word.push_back(c);
+        fuzzySearchHelper(nextState, automaton, rows, word, matches);
+        word.pop_back();
+    }
+}
+
+template<typename Alphabet>
+std::vector<std::string> BasicDoubleArrayTrie<Alphabet>::matchPattern(const std::string& pattern) const {
+    std::vector<std::string> matches;
+    GlobPattern glob(pattern);
+
+    std::vector<uint64_t> states(glob.stateWords());
+    glob.start(states.data());
+
+    std::string word;
+    matchPatternHelper(0, glob, states, word, matches);
+    return matches;
+}
+
+template<typename Alphabet>
+void BasicDoubleArrayTrie<Alphabet>::matchPatternHelper(int state, const GlobPattern& glob,
+                                                        std::vector<uint64_t>& states, std::string& word,
+                                                        std::vector<std::string>& matches) const {
+    size_t width = glob.stateWords();
+    size_t depth = word.size();
+
+    if (base[state] < 0 && glob.isMatch(&states[depth * width])) {
+        matches.push_back(word);
+    }
+
+    int forced = glob.forcedChar(&states[depth * width]);
+    if (forced == GlobPattern::NO_CHAR) {
+        return;
+    }
+
+    if (states.size() < (depth + 2) * width) {
+        states.resize((depth + 2) * width);
+    }
+
+    // a literal next character is a single transition; otherwise try every code
+    int firstCode = 0;
+    int lastCode = Alphabet::size - 1;
+    if (forced != GlobPattern::ANY_CHAR) {
+        firstCode = lastCode = Alphabet::toCode(static_cast<char>(forced));
+    }
+
+    for (int code = firstCode; code <= lastCode; code++) {
+        int nextState = getTransition(state, code);
+        if (nextState == EMPTY) {
+            continue;
+        }
+
+        char c = Alphabet::toChar(code);
+        if (glob.step(&states[depth * width], &states[(depth + 1) * width], c)) {
+            word.push_back(c);
+            matchPatternHelper(nextState, glob, states, word, matches);
+            word.pop_back();
+        }
     }
-    
-    return static_cast<double>(usedCount) / base.size();
 }
 
-void DoubleArrayTrie::clear() {
+template<typename Alphabet>
+size_t BasicDoubleArrayTrie<Alphabet>::getMemoryUsage() const {
+    return base.size() * sizeof(int) + check.size() * sizeof(int);
+}
+
+template<typename Alphabet>
+TrieStats BasicDoubleArrayTrie<Alphabet>::stats() const {
+    TrieStats snapshot;
+    snapshot.memoryBytes = getMemoryUsage();
+    snapshot.nodes = stateCount;
+    snapshot.words = wordCount;
+    snapshot.relocations = relocations.get();
+    snapshot.findBaseCalls = findBaseCalls.get();
+    snapshot.findBaseProbes = findBaseProbes.get();
+    snapshot.lookups = lookups.get();
+    snapshot.nodesVisited = nodesVisited.get();
+    return snapshot;
+}
+
+template<typename Alphabet>
+double BasicDoubleArrayTrie<Alphabet>::getSpaceEfficiency() const {
+    if (base.size() == 0) return 0.0;
+
+    return static_cast<double>(stateCount) / base.size();
+}
+
+template<typename Alphabet>
+void BasicDoubleArrayTrie<Alphabet>::clear() {
     base.clear();
     check.clear();
-    used.clear();
-    base.resize(INITIAL_SIZE, EMPTY);
-    check.resize(INITIAL_SIZE, EMPTY);
-    used.resize(INITIAL_SIZE, false);
-    
+    freeHead = EMPTY;
+    resize(INITIAL_SIZE);
+
+    unlinkFree(0);
     base[0] = 1;
-    check[0] = EMPTY;
-    used[0] = true;
-    
+    check[0] = 0;
+
     wordCount = 0;
+    stateCount = 1;
     maxState = 0;
+    relocations.reset();
+    findBaseCalls.reset();
+    findBaseProbes.reset();
+    lookups.reset();
+    nodesVisited.reset();
 }
 
-void DoubleArrayTrie::compact() {
+template<typename Alphabet>
+void BasicDoubleArrayTrie<Alphabet>::compact() {
     // Trim arrays to only used portion
     size_t newSize = maxState + 1;
     base.resize(newSize);
     check.resize(newSize);
-    used.resize(newSize);
-}
-
-int DoubleArrayTrie::findBase(int state, const std::unordered_set<char>& chars) {
-    for (int b = 1; b < static_cast<int>(base.size()); b++) {
-        bool valid = true;
-        
-        for (char c : chars) {
-            int code = static_cast<unsigned char>(c);
-            int pos = b + code;
-            
-            if (pos >= static_cast<int>(base.size())) {
-                continue;
-            }
-            
-            if (used[pos] && check[pos] != state) {
-                valid = false;
-                break;
+    base.shrink_to_fit();
+    check.shrink_to_fit();
+    rebuildFreeList();
+}
+
+// Adds a transition that doesn't exist yet. If the slot is taken by
+// another state, all children of this state move to a new base.
+template<typename Alphabet>
+int BasicDoubleArrayTrie<Alphabet>::addTransition(int state, int code) {
+    int nextState = baseOf(state) + code;
+
+    if (!isFree(nextState)) {
+        std::vector<int> codes;
+        for (int ch = 0; ch < Alphabet::size; ch++) {
+            if (getTransition(state, ch) != EMPTY) {
+                codes.push_back(ch);
             }
         }
-        
-        if (valid) {
-            return b;
+
+        std::vector<int> allCodes = codes;
+        allCodes.push_back(code);
+
+        int newBase = findBase(allCodes);
+        relocate(state, newBase, codes);
+        nextState = newBase + code;
+    }
+
+    ensureSize(nextState);
+
+    setTransition(state, nextState);
+    return nextState;
+}
+
+// Finds the first base (walking the free list) where every code lands on
+// a free slot. Slots past the end of the arrays count as free.
+template<typename Alphabet>
+int BasicDoubleArrayTrie<Alphabet>::findBase(const std::vector<int>& codes) {
+    int minCode = *std::min_element(codes.begin(), codes.end());
+    size_t probes = 0;
+    findBaseCalls.add(1);
+
+    if (freeHead != EMPTY) {
+        int pos = freeHead;
+        do {
+            probes++;
+            if (pos > minCode) {
+                int b = pos - minCode;
+                bool valid = true;
+
+                for (int code : codes) {
+                    if (!isFree(b + code)) {
+                        valid = false;
+                        break;
+                    }
+                }
+
+                if (valid) {
+                    findBaseProbes.add(probes);
+                    return b;
+                }
+            }
+            pos = -check[pos] - 1;
+        } while (pos != freeHead);
+    }
+
+    findBaseProbes.add(probes);
+    return std::max(static_cast<int>(base.size()), minCode + 1) - minCode;
+}
+
+// Moves the children of a state to a new base. Grandchildren point back
+// at their parent through check[], so they have to be re-parented too.
+template<typename Alphabet>
+void BasicDoubleArrayTrie<Alphabet>::relocate(int state, int newBase, const std::vector<int>& codes) {
+    int oldBase = baseOf(state);
+    relocations.add(1);
+
+    for (int code : codes) {
+        int oldNext = oldBase + code;
+        int newNext = newBase + code;
+
+        ensureSize(newNext);
+
+        unlinkFree(newNext);
+        base[newNext] = base[oldNext];
+        check[newNext] = state;
+
+        int childBase = baseOf(oldNext);
+        for (int ch = 0; ch < Alphabet::size; ch++) {
+            int grandChild = childBase + ch;
+            if (grandChild < static_cast<int>(check.size()) && check[grandChild] == oldNext) {
+                check[grandChild] = newNext;
+            }
         }
+
+        // reuse the vacated slot first
+        linkFree(oldNext, true);
+        maxState = std::max(maxState, static_cast<size_t>(newNext));
     }
-    
-    return base.size();
+
+    base[state] = base[state] < 0 ? -newBase - 1 : newBase;
 }
 
-void DoubleArrayTrie::resize(size_t newSize) {
-    base.resize(newSize, EMPTY);
-    check.resize(newSize, EMPTY);
-    used.resize(newSize, false);
+template<typename Alphabet>
+void BasicDoubleArrayTrie<Alphabet>::resize(size_t newSize) {
+    size_t oldSize = base.size();
+    base.resize(newSize);
+    check.resize(newSize);
+
+    for (size_t pos = oldSize; pos < newSize; pos++) {
+        linkFree(static_cast<int>(pos), false);
+    }
 }
 
-int DoubleArrayTrie::getTransition(int state, char c) const {
-    if (state < 0 || state >= static_cast<int>(base.size())) {
+// Grows by at least half the current size, so the copies and free-list
+// linking of a long run of inserts are amortized O(1) per slot
+template<typename Alphabet>
+void BasicDoubleArrayTrie<Alphabet>::ensureSize(size_t pos) {
+    if (pos >= base.size()) {
+        resize(std::max(pos + 1, base.size() + base.size() / 2));
+    }
+}
+
+template<typename Alphabet>
+void BasicDoubleArrayTrie<Alphabet>::linkFree(int pos, bool atHead) {
+    if (freeHead == EMPTY) {
+        base[pos] = -pos - 1;
+        check[pos] = -pos - 1;
+        freeHead = pos;
+        return;
+    }
+
+    // insert between the tail and the head of the circular list
+    int next = freeHead;
+    int prev = -base[next] - 1;
+    check[prev] = -pos - 1;
+    base[next] = -pos - 1;
+    base[pos] = -prev - 1;
+    check[pos] = -next - 1;
+
+    if (atHead) {
+        freeHead = pos;
+    }
+}
+
+template<typename Alphabet>
+void BasicDoubleArrayTrie<Alphabet>::unlinkFree(int pos) {
+    int next = -check[pos] - 1;
+    int prev = -base[pos] - 1;
+
+    if (next == pos) {
+        freeHead = EMPTY;
+        return;
+    }
+
+    check[prev] = -next - 1;
+    base[next] = -prev - 1;
+
+    if (freeHead == pos) {
+        freeHead = next;
+    }
+}
+
+template<typename Alphabet>
+void BasicDoubleArrayTrie<Alphabet>::rebuildFreeList() {
+    freeHead = EMPTY;
+    for (size_t pos = 0; pos < check.size(); pos++) {
+        if (check[pos] < 0) {
+            linkFree(static_cast<int>(pos), false);
+        }
+    }
+}
+
+template<typename Alphabet>
+int BasicDoubleArrayTrie<Alphabet>::getTransition(int state, int code) const {
+    if (state < 0 || state >= static_cast<int>(base.size()) || code < 0) {
         return EMPTY;
     }
-    
-    int b = base[state];
-    if (b < 0) b = -b - 1;  // Handle end-of-word marker
-    
-    int code = static_cast<unsigned char>(c);
-    int nextState = b + code;
-    
-    if (nextState >= 0 && nextState < static_cast<int>(check.size()) && 
-        check[nextState] == state) {
+
+    int nextState = baseOf(state) + code;
+
+    if (nextState < static_cast<int>(check.size()) && check[nextState] == state) {
         return nextState;
     }
-    
+
     return EMPTY;
 }
 
-void DoubleArrayTrie::setTransition(int state, char c, int nextState) {
-    int code = static_cast<unsigned char>(c);
+template<typename Alphabet>
+void BasicDoubleArrayTrie<Alphabet>::setTransition(int state, int nextState) {
+    unlinkFree(nextState);
     check[nextState] = state;
     base[nextState] = 1;  // Default base for new states
-    used[nextState] = true;
+    stateCount++;
+    maxState = std::max(maxState, static_cast<size_t>(nextState));
 }
 
-bool DoubleArrayTrie::isValidTransition(int state, char c, int nextState) const {
-    if (nextState < 0 || nextState >= static_cast<int>(check.size())) {
-        return false;
+// Bulk construction, used by freeze() on the pointer tries. A state gets
+// its whole child block in one go, so nothing is ever relocated. Returns
+// the base; the child for code c is base + c.
+template<typename Alphabet>
+int BasicDoubleArrayTrie<Alphabet>::placeChildren(int state, const std::vector<int>& codes) {
+    int b = findBulkBase(codes);
+    ensureSize(b + *std::max_element(codes.begin(), codes.end()));
+    base[state] = base[state] < 0 ? -b - 1 : b;
+
+    for (int code : codes) {
+        setTransition(state, b + code);
+    }
+    return b;
+}
+
+// Like findBase, but slots that stay near the head of the free list
+// without ever fitting a block are dropped as starting points: once a
+// walk is more than BULK_PROBE_LIMIT slots long, the head trails it at
+// that distance. Without relocations those slots would only be probed
+// again and again, which is what makes one-by-one building quadratic.
+template<typename Alphabet>
+int BasicDoubleArrayTrie<Alphabet>::findBulkBase(const std::vector<int>& codes) {
+    int minCode = *std::min_element(codes.begin(), codes.end());
+    size_t probes = 0;
+    findBaseCalls.add(1);
+
+    if (freeHead != EMPTY) {
+        int start = freeHead;
+        int pos = start;
+        do {
+            probes++;
+            if (pos > minCode) {
+                int b = pos - minCode;
+                bool valid = true;
+
+                for (int code : codes) {
+                    if (!isFree(b + code)) {
+                        valid = false;
+                        break;
+                    }
+                }
+
+                if (valid) {
+                    findBaseProbes.add(probes);
+                    return b;
+                }
+            }
+            if (probes > BULK_PROBE_LIMIT) {
+                freeHead = -check[freeHead] - 1;
+            }
+            pos = -check[pos] - 1;
+        } while (pos != start);
+    }
+
+    findBaseProbes.add(probes);
+    return std::max(static_cast<int>(base.size()), minCode + 1) - minCode;
+}
+
+template<typename Alphabet>
+void BasicDoubleArrayTrie<Alphabet>::markEndOfWord(int state) {
+    if (base[state] >= 0) {
+        base[state] = -base[state] - 1;
+        wordCount++;
     }
-    
-    return check[nextState] == state;
 }
+
+// Explicit template instantiations
+template class BasicDoubleArrayTrie<ByteAlphabet>;
+template class BasicDoubleArrayTrie<LowercaseAlphabet>;
+template class BasicDoubleArrayTrie<DnaAlphabet>;
@@ -0,0 +1,396 @@
+#include "durable_trie.h"
+#include "compressed_trie.h"
+#include "standard_trie.h"
+#include "packed_strings.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint8_t OP_INSERT = 1;
+constexpr uint8_t OP_REMOVE = 2;
+
+// A log record is [checksum u32][key length u32][op u8][key]. The
+// checksum covers everything after it, so a torn write at the end of the
+// log shows up as a short or mismatching record.
+constexpr size_t RECORD_HEADER = 9;
+
+// A checkpoint is the magic, the key count (u64), every key in order as
+// varint(bytes shared with the previous key) varint(rest length) rest,
+// and a checksum (u32) of everything between the magic and it
+constexpr char CHECKPOINT_MAGIC[8] = {'T', 'R', 'I', 'E', 'C', 'K', 'P', '1'};
+constexpr size_t CHECKPOINT_CHUNK = 1 << 20;
+
+// FNV-1a, continued from hash
+uint32_t checksum(const char* data, size_t size, uint32_t hash = 0x811c9dc5u) {
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 0x01000193u;
+    }
+    return hash;
+}
+
+// False on any error but a missing file, which leaves data empty
+bool readFile(const std::string& path, std::string& data) {
+    data.clear();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return errno == ENOENT;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0) {
+        data.reserve(info.st_size);
+    }
+
+    char chunk[64 * 1024];
+    while (true) {
+        ssize_t n = ::read(fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            ::close(fd);
+            return n == 0;
+        }
+        data.append(chunk, n);
+    }
+}
+
+// Like readVarint, but fails instead of reading past end
+bool readVarintChecked(const std::string& data, size_t& pos, size_t end, size_t& value) {
+    value = 0;
+    for (int shift = 0; pos < end && shift < 64; shift += 7) {
+        unsigned char byte = static_cast<unsigned char>(data[pos++]);
+        value |= static_cast<size_t>(byte & 0x7f) << shift;
+        if (byte < 0x80) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+template<typename TrieType>
+DurableTrie<TrieType>::DurableTrie()
+    : logFd(-1), pendingRecords(0), logBytes(0), checkpointBytes(0), failed(false) {}
+
+template<typename TrieType>
+DurableTrie<TrieType>::~DurableTrie() {
+    close();
+}
+
+template<typename TrieType>
+bool DurableTrie<TrieType>::open(const std::string& path, const DurabilityOptions& opts) {
+    close();
+    trie.clear();
+    options = opts;
+    directory = path;
+    pending.clear();
+    pendingRecords = 0;
+    logBytes = 0;
+    checkpointBytes = 0;
+    failed = false;
+    recovery = RecoveryInfo();
+
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        return fail("mkdir");
+    }
+    // Left over from a checkpoint that never got renamed into place
+    unlink((checkpointPath() + ".tmp").c_str());
+
+    if (!loadCheckpoint() || !replayLog()) {
+        failed = true;
+        return false;
+    }
+
+    logFd = ::open(logPath().c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (logFd < 0) {
+        return fail("opening the log");
+    }
+    if (recovery.discardedBytes > 0 &&
+        (ftruncate(logFd, static_cast<off_t>(logBytes)) != 0 || !syncFile(logFd))) {
+        return fail("truncating the log");
+    }
+    if (!syncDirectory()) {
+        return fail("syncing the directory");
+    }
+    return true;
+}
+
+template<typename TrieType>
+bool DurableTrie<TrieType>::close() {
+    if (logFd < 0) {
+        return !failed;
+    }
+    bool ok = commit();
+    ::close(logFd);
+    logFd = -1;
+    return ok;
+}
+
+template<typename TrieType>
+void DurableTrie<TrieType>::insert(const std::string& word) {
+    size_t before = trie.getWordCount();
+    trie.insert(word);
+    if (trie.getWordCount() != before) {
+        append(OP_INSERT, word);
+    }
+}
+
+template<typename TrieType>
+bool DurableTrie<TrieType>::remove(const std::string& word) {
+    if (!trie.remove(word)) {
+        return false;
+    }
+    append(OP_REMOVE, word);
+    return true;
+}
+
+// Only changes that took effect are logged, so replay never meets a
+// duplicate insert or a remove of a missing key it would have to skip
+template<typename TrieType>
+void DurableTrie<TrieType>::append(uint8_t op, const std::string& word) {
+    if (logFd < 0 || failed) return;
+
+    size_t start = pending.size();
+    uint32_t length = static_cast<uint32_t>(word.size());
+    pending.append(sizeof(uint32_t), '\0');
+    pending.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    pending.push_back(static_cast<char>(op));
+    pending.append(word);
+
+    uint32_t sum = checksum(&pending[start + sizeof(uint32_t)], pending.size() - start - sizeof(uint32_t));
+    std::memcpy(&pending[start], &sum, sizeof(sum));
+
+    if (++pendingRecords >= options.groupCommitRecords) {
+        commit();
+    }
+}
+
+template<typename TrieType>
+bool DurableTrie<TrieType>::commit() {
+    if (!flush()) return false;
+    if (logFd >= 0 && logBytes >= options.checkpointLogBytes) {
+        return checkpoint();
+    }
+    return true;
+}
+
+template<typename TrieType>
+bool DurableTrie<TrieType>::flush() {
+    if (failed) return false;
+    if (logFd < 0 || pending.empty()) return true;
+
+    if (!writeAll(logFd, pending.data(), pending.size()) || (options.sync && !syncFile(logFd))) {
+        return fail("writing the log");
+    }
+    logBytes += pending.size();
+    pending.clear();
+    pendingRecords = 0;
+    return true;
+}
+
+// The new checkpoint is written beside the old one and renamed over it,
+// so a crash leaves one complete checkpoint plus the log that goes with
+// it. Only then is the log emptied.
+template<typename TrieType>
+bool DurableTrie<TrieType>::checkpoint() {
+    if (logFd < 0 || !flush()) return false;
+
+    std::string tmpPath = checkpointPath() + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return fail("creating the checkpoint");
+    }
+
+    std::string buffer(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    uint64_t count = trie.getWordCount();
+    buffer.append(reinterpret_cast<const char*>(&count), sizeof(count));
+    uint32_t sum = checksum(buffer.data() + sizeof(CHECKPOINT_MAGIC), sizeof(count));
+    size_t checksummed = buffer.size();
+    size_t written = 0;
+    std::string previous;
+    bool ok = true;
+
+    trie.rangeScan("", "", [&](const std::string& key) {
+        size_t shared = 0;
+        while (shared < previous.size() && shared < key.size() && previous[shared] == key[shared]) {
+            shared++;
+        }
+        appendVarint(buffer, shared);
+        appendVarint(buffer, key.size() - shared);
+        buffer.append(key, shared, std::string::npos);
+        previous = key;
+
+        if (buffer.size() >= CHECKPOINT_CHUNK) {
+            sum = checksum(buffer.data() + checksummed, buffer.size() - checksummed, sum);
+            ok = writeAll(fd, buffer.data(), buffer.size());
+            written += buffer.size();
+            buffer.clear();
+            checksummed = 0;
+        }
+        return ok;
+    });
+
+    sum = checksum(buffer.data() + checksummed, buffer.size() - checksummed, sum);
+    buffer.append(reinterpret_cast<const char*>(&sum), sizeof(sum));
+    ok = ok && writeAll(fd, buffer.data(), buffer.size()) && syncFile(fd);
+    written += buffer.size();
+    ::close(fd);
+
+    if (!ok || rename(tmpPath.c_str(), checkpointPath().c_str()) != 0 || !syncDirectory()) {
+        return fail("writing the checkpoint");
+    }
+    if (ftruncate(logFd, 0) != 0 || !syncFile(logFd)) {
+        return fail("truncating the log");
+    }
+    logBytes = 0;
+    checkpointBytes = written;
+    return true;
+}
+
+template<typename TrieType>
+bool DurableTrie<TrieType>::loadCheckpoint() {
+    std::string data;
+    if (!readFile(checkpointPath(), data)) {
+        return fail("reading the checkpoint");
+    }
+    if (data.empty()) {
+        return true;
+    }
+
+    size_t header = sizeof(CHECKPOINT_MAGIC) + sizeof(uint64_t);
+    size_t end = data.size() - sizeof(uint32_t);
+    uint32_t stored = 0;
+    uint64_t count = 0;
+    bool valid = data.size() >= header + sizeof(uint32_t) &&
+                 std::memcmp(data.data(), CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) == 0;
+    if (valid) {
+        std::memcpy(&stored, &data[end], sizeof(stored));
+        std::memcpy(&count, &data[sizeof(CHECKPOINT_MAGIC)], sizeof(count));
+        valid = stored == checksum(&data[sizeof(CHECKPOINT_MAGIC)], end - sizeof(CHECKPOINT_MAGIC));
+    }
+
+    std::string key;
+    size_t pos = header;
+    for (uint64_t i = 0; valid && i < count; i++) {
+        size_t shared;
+        size_t rest;
+        valid = readVarintChecked(data, pos, end, shared) && readVarintChecked(data, pos, end, rest) &&
+                shared <= key.size() && rest <= end - pos;
+        if (valid) {
+            key.resize(shared);
+            key.append(data, pos, rest);
+            pos += rest;
+            trie.insert(key);
+        }
+    }
+
+    if (!valid || pos != end || trie.getWordCount() != count) {
+        std::cerr << "Corrupt checkpoint: " << checkpointPath() << std::endl;
+        trie.clear();
+        return false;
+    }
+    checkpointBytes = data.size();
+    recovery.checkpointKeys = count;
+    return true;
+}
+
+// Applies records up to the first incomplete or mismatching one; open()
+// cuts the log off there
+template<typename TrieType>
+bool DurableTrie<TrieType>::replayLog() {
+    std::string data;
+    if (!readFile(logPath(), data)) {
+        return fail("reading the log");
+    }
+
+    size_t pos = 0;
+    std::string key;
+    while (data.size() - pos >= RECORD_HEADER) {
+        uint32_t stored;
+        uint32_t length;
+        std::memcpy(&stored, &data[pos], sizeof(stored));
+        std::memcpy(&length, &data[pos + sizeof(stored)], sizeof(length));
+        uint8_t op = static_cast<uint8_t>(data[pos + 2 * sizeof(uint32_t)]);
+
+        if (length > data.size() - pos - RECORD_HEADER ||
+            stored != checksum(&data[pos + sizeof(stored)], RECORD_HEADER - sizeof(stored) + length) ||
+            (op != OP_INSERT && op != OP_REMOVE)) {
+            break;
+        }
+
+        key.assign(data, pos + RECORD_HEADER, length);
+        if (op == OP_INSERT) {
+            trie.insert(key);
+        } else {
+            trie.remove(key);
+        }
+        pos += RECORD_HEADER + length;
+        recovery.replayedRecords++;
+    }
+
+    logBytes = pos;
+    recovery.discardedBytes = data.size() - pos;
+    return true;
+}
+
+template<typename TrieType>
+bool DurableTrie<TrieType>::writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+template<typename TrieType>
+bool DurableTrie<TrieType>::syncFile(int fd) {
+#ifdef __linux__
+    return fdatasync(fd) == 0;
+#else
+    return fsync(fd) == 0;
+#endif
+}
+
+// Makes creating, renaming or truncating a file in the directory durable
+template<typename TrieType>
+bool DurableTrie<TrieType>::syncDirectory() {
+    int fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+template<typename TrieType>
+bool DurableTrie<TrieType>::fail(const std::string& what) {
+    std::cerr << "Error: " << what << " in " << directory << ": " << std::strerror(errno) << std::endl;
+    failed = true;
+    return false;
+}
+
+template<typename TrieType>
+TrieStats DurableTrie<TrieType>::stats() const {
+    TrieStats snapshot = trie.stats();
+    snapshot.memoryBytes = getMemoryUsage();
+    return snapshot;
+}
+
+// Explicit template instantiations
+template class DurableTrie<CompressedTrie>;
+template class DurableTrie<BasicCompressedTrie<LowercaseAlphabet>>;
+template class DurableTrie<StandardTrie>;
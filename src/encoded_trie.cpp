@@ -0,0 +1,74 @@
+#include "encoded_trie.h"
+#include "standard_trie.h"
+#include "compressed_trie.h"
+#include "double_array_trie.h"
+
+template<typename TrieType>
+void EncodedTrie<TrieType>::train(const std::vector<std::string>& sample) {
+    std::vector<std::string> stored;
+    if (trie.getWordCount() > 0) {
+        rangeScan("", "", [&stored](const std::string& key) {
+            stored.push_back(key);
+            return true;
+        });
+        trie.clear();
+    }
+
+    encoder.train(sample);
+
+    for (const auto& key : stored) {
+        insert(key);
+    }
+}
+
+template<typename TrieType>
+void EncodedTrie<TrieType>::insert(const std::string& word) {
+    trie.insert(encoder.encode(word));
+}
+
+template<typename TrieType>
+bool EncodedTrie<TrieType>::search(const std::string& word) const {
+    return trie.search(encoder.encode(word));
+}
+
+// Encoded prefixes are not prefixes of the encoded keys, but keys that
+// start with prefix are exactly those in [prefix, successor), so the
+// first key at or after the encoded prefix decides
+template<typename TrieType>
+bool EncodedTrie<TrieType>::startsWith(const std::string& prefix) const {
+    if (prefix.empty()) {
+        return trie.getWordCount() > 0;
+    }
+    std::string next = lowerBound(prefix);
+    return next.compare(0, prefix.size(), prefix) == 0;
+}
+
+template<typename TrieType>
+void EncodedTrie<TrieType>::rangeScan(const std::string& lo, const std::string& hi, const KeyCallback& onKey) const {
+    trie.rangeScan(encoder.encode(lo), encoder.encode(hi), [&](const std::string& code) {
+        return onKey(encoder.decode(code));
+    });
+}
+
+template<typename TrieType>
+std::string EncodedTrie<TrieType>::lowerBound(const std::string& key) const {
+    return encoder.decode(trie.lowerBound(encoder.encode(key)));
+}
+
+template<typename TrieType>
+TrieStats EncodedTrie<TrieType>::stats() const {
+    TrieStats snapshot = trie.stats();
+    snapshot.memoryBytes = getMemoryUsage();
+    return snapshot;
+}
+
+template<typename TrieType>
+void EncodedTrie<TrieType>::clear() {
+    trie.clear();
+    encoder.clear();
+}
+
+// Explicit template instantiations
+template class EncodedTrie<StandardTrie>;
+template class EncodedTrie<CompressedTrie>;
+template class EncodedTrie<DoubleArrayTrie>;
@@ -0,0 +1,312 @@
+#include "flat_trie.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+template<typename Alphabet>
+BasicFlatTrie<Alphabet>::BasicFlatTrie() : buffer(sizeof(NodeHeader)), wordCount(0), nodeCount(1) {}
+
+template<typename Alphabet>
+bool BasicFlatTrie<Alphabet>::search(const std::string& word) const {
+    size_t node = 0;
+    size_t pos = 0;
+    size_t visited = 0;
+    bool found = false;
+
+    while (true) {
+        std::string_view label = labelOf(node);
+        if (word.compare(pos, label.size(), label.data(), label.size()) != 0) {
+            break;
+        }
+        pos += label.size();
+        if (pos == word.size()) {
+            found = header(node)->isEndOfWord;
+            break;
+        }
+
+        size_t child = findChild(node, Alphabet::toCode(word[pos]));
+        if (child == NO_SLOT) {
+            break;
+        }
+        node = child;
+        pos++;
+        visited++;
+    }
+
+    lookups.add(1);
+    nodesVisited.add(visited);
+    return found;
+}
+
+// The prefix may end inside an edge label
+template<typename Alphabet>
+bool BasicFlatTrie<Alphabet>::startsWith(const std::string& prefix) const {
+    size_t node = 0;
+    size_t pos = 0;
+    size_t visited = 0;
+    bool found = false;
+
+    while (true) {
+        std::string_view label = labelOf(node);
+        size_t n = std::min(label.size(), prefix.size() - pos);
+        if (prefix.compare(pos, n, label.data(), n) != 0) {
+            break;
+        }
+        pos += n;
+        if (pos == prefix.size()) {
+            found = true;
+            break;
+        }
+
+        size_t child = findChild(node, Alphabet::toCode(prefix[pos]));
+        if (child == NO_SLOT) {
+            break;
+        }
+        node = child;
+        pos++;
+        visited++;
+    }
+
+    lookups.add(1);
+    nodesVisited.add(visited);
+    return found;
+}
+
+template<typename Alphabet>
+size_t BasicFlatTrie<Alphabet>::longestPrefixMatch(std::string_view input) const {
+    size_t node = 0;
+    size_t pos = 0;
+    size_t longest = 0;
+
+    while (true) {
+        std::string_view label = labelOf(node);
+        if (input.substr(pos, label.size()) != label) {
+            break;
+        }
+        pos += label.size();
+        if (header(node)->isEndOfWord) {
+            longest = pos;
+        }
+        if (pos == input.size()) {
+            break;
+        }
+
+        size_t child = findChild(node, Alphabet::toCode(input[pos]));
+        if (child == NO_SLOT) {
+            break;
+        }
+        node = child;
+        pos++;
+    }
+
+    return longest;
+}
+
+template<typename Alphabet>
+void BasicFlatTrie<Alphabet>::rangeScan(const std::string& lo, const std::string& hi,
+                                        const KeyCallback& onKey) const {
+    std::string word;
+    rangeScanHelper(0, true, lo, hi, word, onKey);
+}
+
+// tight: word is still a prefix of lo, so children whose edge sorts
+// before lo are skipped. Returns false once the scan is over.
+template<typename Alphabet>
+bool BasicFlatTrie<Alphabet>::rangeScanHelper(size_t node, bool tight, const std::string& lo,
+                                              const std::string& hi, std::string& word,
+                                              const KeyCallback& onKey) const {
+    if (!hi.empty() && word >= hi) {
+        return false;
+    }
+
+    size_t depth = word.size();
+    if (tight && depth == lo.size()) {
+        tight = false;
+    }
+
+    if (!tight && header(node)->isEndOfWord && !onKey(word)) {
+        return false;
+    }
+
+    const uint8_t* codes = codesOf(node);
+    const uint32_t* offsets = offsetsOf(node);
+    uint16_t count = header(node)->childCount;
+    int firstCode = tight ? lowerBoundCode<Alphabet>(lo[depth]) : 0;
+
+    for (uint16_t i = std::lower_bound(codes, codes + count, firstCode) - codes; i < count; i++) {
+        size_t child = offsets[i];
+        word.push_back(Alphabet::toChar(codes[i]));
+        word.append(labelOf(child));
+        bool childTight = false;
+
+        if (tight) {
+            size_t m = depth;
+            while (m < word.size() && m < lo.size() && word[m] == lo[m]) {
+                m++;
+            }
+            if (m == word.size()) {
+                childTight = true;
+            } else if (m < lo.size() &&
+                       static_cast<unsigned char>(word[m]) < static_cast<unsigned char>(lo[m])) {
+                word.resize(depth);
+                continue;  // whole subtree sorts before lo
+            }
+        }
+
+        bool more = rangeScanHelper(child, childTight, lo, hi, word, onKey);
+        word.resize(depth);
+        if (!more) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Alphabet>
+const uint32_t* BasicFlatTrie<Alphabet>::offsetsOf(size_t node) const {
+    const NodeHeader* h = header(node);
+    size_t codesEnd = node + sizeof(NodeHeader) + h->labelLength + h->childCount;
+    return reinterpret_cast<const uint32_t*>(&buffer[(codesEnd + 3) & ~size_t(3)]);
+}
+
+template<typename Alphabet>
+std::string_view BasicFlatTrie<Alphabet>::labelOf(size_t node) const {
+    return std::string_view(reinterpret_cast<const char*>(&buffer[node + sizeof(NodeHeader)]),
+                            header(node)->labelLength);
+}
+
+// Offset of the child for code, NO_SLOT if there is none. The codes of a
+// node are contiguous and sorted, so short lists are scanned and long
+// ones binary searched.
+template<typename Alphabet>
+size_t BasicFlatTrie<Alphabet>::findChild(size_t node, int code) const {
+    if (code < 0) {
+        return NO_SLOT;
+    }
+
+    const uint8_t* codes = codesOf(node);
+    uint16_t count = header(node)->childCount;
+    uint16_t i = 0;
+
+    if (count <= LINEAR_SEARCH_MAX) {
+        while (i < count && codes[i] < code) {
+            i++;
+        }
+    } else {
+        i = std::lower_bound(codes, codes + count, code) - codes;
+    }
+
+    if (i == count || codes[i] != code) {
+        return NO_SLOT;
+    }
+    return offsetsOf(node)[i];
+}
+
+// Nodes are written in their final order and each one patches its offset
+// into the slot its parent left for it. The queue is breadth first until
+// the hot region is full; what is still queued then are the roots of the
+// subtrees written depth first.
+template<typename Alphabet>
+void BasicFlatTrie<Alphabet>::build(const void* root, const Describe& describe) {
+    buffer.clear();
+    wordCount = 0;
+    nodeCount = 0;
+
+    std::vector<std::pair<const void*, size_t>> pending{{root, NO_SLOT}};
+    SourceNode scratch;
+    size_t head = 0;
+
+    while (head < pending.size() && buffer.size() < HOT_BYTES) {
+        auto [source, slot] = pending[head++];
+        emit(source, slot, describe, scratch, pending);
+    }
+
+    std::vector<std::pair<const void*, size_t>> stack(pending.rbegin(), pending.rend() - head);
+    std::vector<std::pair<const void*, size_t>>().swap(pending);
+
+    while (!stack.empty()) {
+        auto [source, slot] = stack.back();
+        stack.pop_back();
+
+        size_t first = stack.size();
+        emit(source, slot, describe, scratch, stack);
+        std::reverse(stack.begin() + first, stack.end());
+    }
+
+    buffer.shrink_to_fit();
+}
+
+// Appends one node and queues its children with the slots their offsets
+// go into
+template<typename Alphabet>
+void BasicFlatTrie<Alphabet>::emit(const void* source, size_t slot, const Describe& describe, SourceNode& scratch,
+                                   std::vector<std::pair<const void*, size_t>>& pending) {
+    scratch.children.clear();
+    describe(source, scratch);
+
+    size_t node = buffer.size();
+    if (node > UINT32_MAX) {
+        throw std::length_error("flat trie past 4 GB, child offsets would wrap");
+    }
+    if (slot != NO_SLOT) {
+        uint32_t offset = static_cast<uint32_t>(node);
+        std::memcpy(&buffer[slot], &offset, sizeof(offset));
+    }
+
+    size_t count = scratch.children.size();
+    size_t codesAt = node + sizeof(NodeHeader) + scratch.label.size();
+    size_t offsetsAt = (codesAt + count + 3) & ~size_t(3);
+    buffer.resize(offsetsAt + count * sizeof(uint32_t));
+
+    NodeHeader h{static_cast<uint32_t>(scratch.label.size()), static_cast<uint16_t>(count),
+                 static_cast<uint8_t>(scratch.isEndOfWord), 0};
+    std::memcpy(&buffer[node], &h, sizeof(h));
+    if (!scratch.label.empty()) {
+        std::memcpy(&buffer[node + sizeof(NodeHeader)], scratch.label.data(), scratch.label.size());
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        buffer[codesAt + i] = static_cast<uint8_t>(scratch.children[i].first);
+        pending.push_back({scratch.children[i].second, offsetsAt + i * sizeof(uint32_t)});
+    }
+
+    nodeCount++;
+    if (scratch.isEndOfWord) {
+        wordCount++;
+    }
+}
+
+template<typename Alphabet>
+TrieStats BasicFlatTrie<Alphabet>::stats() const {
+    TrieStats snapshot;
+    snapshot.memoryBytes = getMemoryUsage();
+    snapshot.nodes = nodeCount;
+    snapshot.words = wordCount;
+    snapshot.lookups = lookups.get();
+    snapshot.nodesVisited = nodesVisited.get();
+    return snapshot;
+}
+
+template<typename Alphabet>
+void BasicFlatTrie<Alphabet>::clear() {
+    buffer.assign(sizeof(NodeHeader), 0);
+    wordCount = 0;
+    nodeCount = 1;
+    lookups.reset();
+    nodesVisited.reset();
+}
+
+template<typename Alphabet>
+std::vector<std::string> BasicFlatTrie<Alphabet>::getAllWords() const {
+    std::vector<std::string> words;
+    rangeScan("", "", [&words](const std::string& key) {
+        words.push_back(key);
+        return true;
+    });
+    return words;
+}
+
+// Explicit template instantiations
+template class BasicFlatTrie<ByteAlphabet>;
+template class BasicFlatTrie<LowercaseAlphabet>;
+template class BasicFlatTrie<DnaAlphabet>;
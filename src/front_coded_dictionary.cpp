@@ -0,0 +1,199 @@
+#include "front_coded_dictionary.h"
+#include <algorithm>
+
+// Length of the common prefix of a and b
+static size_t sharedLength(std::string_view a, std::string_view b) {
+    size_t n = std::min(a.size(), b.size());
+    size_t i = 0;
+    while (i < n && a[i] == b[i]) {
+        i++;
+    }
+    return i;
+}
+
+FrontCodedDictionary::FrontCodedDictionary() : wordCount(0) {}
+
+void FrontCodedDictionary::insert(const std::string& word) {
+    pending.push_back(word);
+}
+
+void FrontCodedDictionary::build() {
+    if (pending.empty()) return;
+
+    if (wordCount > 0) {
+        std::vector<std::string> encoded = getAllWords();
+        pending.insert(pending.end(), encoded.begin(), encoded.end());
+    }
+
+    std::sort(pending.begin(), pending.end());
+    pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+
+    data.clear();
+    blockOffsets.clear();
+    for (size_t i = 0; i < pending.size(); i++) {
+        const std::string& key = pending[i];
+        if (i % BLOCK_SIZE == 0) {
+            blockOffsets.push_back(data.size());
+            insertPacked(data, data.size(), key);
+            continue;
+        }
+
+        size_t shared = sharedLength(pending[i - 1], key);
+        appendVarint(data, shared);
+        insertPacked(data, data.size(), std::string_view(key).substr(shared));
+    }
+
+    wordCount = pending.size();
+    std::vector<std::string>().swap(pending);
+    data.shrink_to_fit();
+    blockOffsets.shrink_to_fit();
+}
+
+// Walks the block keeping only how much of the previous key matched
+// word. Keys are sorted and each one shares exactly `shared` bytes with
+// the one before, so comparing shared against that match length alone
+// says whether the key is still below word, or already past it.
+bool FrontCodedDictionary::search(const std::string& word) const {
+    if (blockOffsets.empty()) return false;
+
+    size_t block = findBlock(word);
+    size_t end = block + 1 < blockOffsets.size() ? blockOffsets[block + 1] : data.size();
+    std::string_view head;
+    size_t pos = readPacked(data, blockOffsets[block], head);
+    size_t visited = 1;
+
+    size_t matched = sharedLength(head, word);
+    bool found = matched == head.size() && matched == word.size();
+    bool past = matched < head.size() &&
+                (matched == word.size() ||
+                 static_cast<unsigned char>(head[matched]) > static_cast<unsigned char>(word[matched]));
+
+    while (!found && !past && pos < end) {
+        size_t shared;
+        std::string_view suffix;
+        pos = readVarint(data, pos, shared);
+        pos = readPacked(data, pos, suffix);
+        visited++;
+
+        if (shared < matched) {
+            break;  // differs from word where the previous key still matched it, and sorts higher
+        }
+        if (shared > matched) {
+            continue;  // follows the previous key past the point where it fell below word
+        }
+
+        size_t n = sharedLength(suffix, std::string_view(word).substr(matched));
+        matched += n;
+        if (n == suffix.size()) {
+            found = matched == word.size();
+        } else {
+            past = matched == word.size() ||
+                   static_cast<unsigned char>(suffix[n]) > static_cast<unsigned char>(word[matched]);
+        }
+    }
+
+    lookups.add(1);
+    nodesVisited.add(visited);
+    return found;
+}
+
+bool FrontCodedDictionary::startsWith(const std::string& prefix) const {
+    bool found = false;
+    rangeScan(prefix, "", [&](const std::string& key) {
+        found = key.compare(0, prefix.size(), prefix) == 0;
+        return false;
+    });
+    return found;
+}
+
+void FrontCodedDictionary::rangeScan(const std::string& lo, const std::string& hi,
+                                     const KeyCallback& onKey) const {
+    if (blockOffsets.empty()) return;
+
+    size_t block = findBlock(lo);
+    size_t pos = blockOffsets[block];
+    std::string key;
+    std::string_view suffix;
+
+    for (size_t i = block * BLOCK_SIZE; i < wordCount; i++) {
+        size_t shared = 0;
+        if (i % BLOCK_SIZE != 0) {
+            pos = readVarint(data, pos, shared);
+        }
+        pos = readPacked(data, pos, suffix);
+        key.resize(shared);
+        key.append(suffix);
+
+        if (key < lo) {
+            continue;
+        }
+        if ((!hi.empty() && key >= hi) || !onKey(key)) {
+            return;
+        }
+    }
+}
+
+void FrontCodedDictionary::prefixScan(const std::string& prefix, const KeyCallback& onKey) const {
+    rangeScan(prefix, "", [&](const std::string& key) {
+        return key.compare(0, prefix.size(), prefix) == 0 && onKey(key);
+    });
+}
+
+std::string_view FrontCodedDictionary::blockHead(size_t block) const {
+    std::string_view head;
+    readPacked(data, blockOffsets[block], head);
+    return head;
+}
+
+// Last block whose head is <= key, or block 0 if key sorts before them all
+size_t FrontCodedDictionary::findBlock(std::string_view key) const {
+    size_t lo = 0;
+    size_t hi = blockOffsets.size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (blockHead(mid) <= key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo > 0 ? lo - 1 : 0;
+}
+
+size_t FrontCodedDictionary::getMemoryUsage() const {
+    size_t bytes = data.capacity() + blockOffsets.capacity() * sizeof(uint64_t) +
+                   pending.capacity() * sizeof(std::string);
+    for (const auto& key : pending) {
+        bytes += packedHeapBytes(key);
+    }
+    return bytes;
+}
+
+TrieStats FrontCodedDictionary::stats() const {
+    TrieStats snapshot;
+    snapshot.memoryBytes = getMemoryUsage();
+    snapshot.nodes = blockOffsets.size();
+    snapshot.words = wordCount;
+    snapshot.lookups = lookups.get();
+    snapshot.nodesVisited = nodesVisited.get();
+    return snapshot;
+}
+
+void FrontCodedDictionary::clear() {
+    std::string().swap(data);
+    std::vector<uint64_t>().swap(blockOffsets);
+    std::vector<std::string>().swap(pending);
+    wordCount = 0;
+    lookups.reset();
+    nodesVisited.reset();
+}
+
+std::vector<std::string> FrontCodedDictionary::getAllWords() const {
+    std::vector<std::string> words;
+    words.reserve(wordCount);
+    rangeScan("", "", [&words](const std::string& key) {
+        words.push_back(key);
+        return true;
+    });
+    return words;
+}
@@ -0,0 +1,44 @@
+#include "frozen_trie.h"
+#include "standard_trie.h"
+#include "compressed_trie.h"
+
+template<typename SourceType, typename Conversion>
+void FrozenTrie<SourceType, Conversion>::build() {
+    // A second build() folds the keys already frozen back into staging so
+    // the new copy holds the union
+    if (frozen.getWordCount() > 0) {
+        frozen.rangeScan("", "", [this](const std::string& key) {
+            staging.insert(key);
+            return true;
+        });
+    }
+    frozen = Conversion::from(staging);
+    staging.clear();
+}
+
+template<typename SourceType, typename Conversion>
+void FrozenTrie<SourceType, Conversion>::rangeScan(const std::string& lo, const std::string& hi,
+                                                   const KeyCallback& onKey) const {
+    frozen.rangeScan(lo, hi, onKey);
+}
+
+template<typename SourceType, typename Conversion>
+TrieStats FrozenTrie<SourceType, Conversion>::stats() const {
+    return frozen.stats();
+}
+
+template<typename SourceType, typename Conversion>
+void FrozenTrie<SourceType, Conversion>::clear() {
+    staging.clear();
+    frozen.clear();
+}
+
+// Explicit template instantiations
+template class FrozenTrie<StandardTrie>;
+template class FrozenTrie<CompressedTrie>;
+template class FrozenTrie<BasicCompressedTrie<LowercaseAlphabet>>;
+template class FrozenTrie<StandardTrie, ToFlatLayout>;
+template class FrozenTrie<CompressedTrie, ToFlatLayout>;
+template class FrozenTrie<BasicCompressedTrie<LowercaseAlphabet>, ToFlatLayout>;
+template class FrozenTrie<CompressedTrie, ToDawg<ByteAlphabet>>;
+template class FrozenTrie<BasicCompressedTrie<LowercaseAlphabet>, ToDawg<LowercaseAlphabet>>;
@@ -0,0 +1,126 @@
+#include "glob_pattern.h"
+#include <algorithm>
+
+GlobPattern::GlobPattern(const std::string& pattern) {
+    for (size_t i = 0; i < pattern.size(); i++) {
+        char c = pattern[i];
+        Token token{Token::LITERAL, c, {}};
+
+        if (c == '?') {
+            token.kind = Token::ANY;
+        } else if (c == '*') {
+            // consecutive stars behave like one
+            if (!tokens.empty() && tokens.back().kind == Token::STAR) {
+                continue;
+            }
+            token.kind = Token::STAR;
+        } else if (c == '\\' && i + 1 < pattern.size()) {
+            token.literal = pattern[++i];
+        } else if (c == '[') {
+            size_t close = pattern.find(']', i + 2);
+            if (close != std::string::npos) {
+                size_t j = i + 1;
+                bool negate = pattern[j] == '^' || pattern[j] == '!';
+                if (negate) j++;
+
+                token.kind = Token::CLASS;
+                for (; j < close; j++) {
+                    unsigned char from = pattern[j];
+                    unsigned char to = from;
+                    if (j + 2 < close && pattern[j + 1] == '-') {
+                        to = pattern[j + 2];
+                        j += 2;
+                    }
+                    for (unsigned v = from; v <= to; v++) {
+                        token.members.set(v);
+                    }
+                }
+                if (negate) token.members.flip();
+                i = close;
+            }
+            // an unterminated '[' is just a literal
+        }
+
+        tokens.push_back(token);
+    }
+
+    words = (tokens.size() + 1 + 63) / 64;
+}
+
+// A star can also match nothing, so its successor is reachable for free
+void GlobPattern::addClosure(uint64_t* states) const {
+    for (size_t i = 0; i < tokens.size(); i++) {
+        if (tokens[i].kind == Token::STAR && ((states[i >> 6] >> (i & 63)) & 1)) {
+            states[(i + 1) >> 6] |= uint64_t(1) << ((i + 1) & 63);
+        }
+    }
+}
+
+void GlobPattern::start(uint64_t* states) const {
+    std::fill(states, states + words, 0);
+    states[0] = 1;
+    addClosure(states);
+}
+
+bool GlobPattern::step(const uint64_t* prev, uint64_t* next, char c) const {
+    std::fill(next, next + words, 0);
+    bool alive = false;
+
+    for (size_t w = 0; w < words; w++) {
+        uint64_t bits = prev[w];
+        while (bits) {
+            size_t i = w * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (i >= tokens.size()) {
+                continue;  // accepting position consumes nothing
+            }
+
+            const Token& token = tokens[i];
+            size_t target;
+            switch (token.kind) {
+                case Token::LITERAL: if (token.literal != c) continue; target = i + 1; break;
+                case Token::CLASS: if (!token.members.test(static_cast<unsigned char>(c))) continue; target = i + 1; break;
+                case Token::ANY: target = i + 1; break;
+                default: target = i; break;  // STAR stays put
+            }
+
+            next[target >> 6] |= uint64_t(1) << (target & 63);
+            alive = true;
+        }
+    }
+
+    if (alive) {
+        addClosure(next);
+    }
+    return alive;
+}
+
+bool GlobPattern::isMatch(const uint64_t* states) const {
+    size_t accept = tokens.size();
+    return (states[accept >> 6] >> (accept & 63)) & 1;
+}
+
+int GlobPattern::forcedChar(const uint64_t* states) const {
+    int forced = NO_CHAR;
+
+    for (size_t w = 0; w < words; w++) {
+        uint64_t bits = states[w];
+        while (bits) {
+            size_t i = w * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (i >= tokens.size()) {
+                continue;
+            }
+            if (tokens[i].kind != Token::LITERAL) {
+                return ANY_CHAR;
+            }
+            int c = static_cast<unsigned char>(tokens[i].literal);
+            if (forced != NO_CHAR && forced != c) {
+                return ANY_CHAR;
+            }
+            forced = c;
+        }
+    }
+
+    return forced;
+}
@@ -0,0 +1,378 @@
+#include "hat_trie.h"
+#include <algorithm>
+#include <utility>
+
+template<typename Alphabet>
+BasicHatTrie<Alphabet>::BasicHatTrie() : wordCount(0), nodeCount(1), memoryBytes(sizeof(TrieNode)) {
+    root = std::make_unique<TrieNode>(false);
+}
+
+template<typename Alphabet>
+void BasicHatTrie<Alphabet>::insert(const std::string& word) {
+    if (!isValidKey<Alphabet>(word)) return;
+
+    TrieNode* node = root.get();
+    size_t depth = 0;
+
+    while (!node->isContainer && depth < word.size()) {
+        int code = Alphabet::toCode(word[depth]);
+        TrieNode* child = node->children.find(code);
+        node = child ? child : addChild(node, code);
+        depth++;
+    }
+
+    if (depth == word.size()) {
+        if (!node->isEndOfWord) {
+            node->isEndOfWord = true;
+            wordCount++;
+        }
+        return;
+    }
+
+    if (addSuffix(node, std::string_view(word).substr(depth))) {
+        wordCount++;
+        if (node->keyCount >= BURST_THRESHOLD) {
+            burst(node);
+        }
+    }
+}
+
+template<typename Alphabet>
+bool BasicHatTrie<Alphabet>::search(const std::string& word) const {
+    size_t depth;
+    const TrieNode* node = descend(word, depth);
+    if (!node) {
+        return false;
+    }
+    if (depth == word.size()) {
+        return node->isEndOfWord;
+    }
+
+    std::string_view suffix = std::string_view(word).substr(depth);
+    return findInSlot(node->slots[slotIndex(node, suffix)], suffix) != std::string::npos;
+}
+
+// Nodes without keys below them are pruned by remove, so reaching the end
+// of the prefix at a node is enough. Inside a container every suffix has
+// to be checked, since hashing scatters the ones sharing a prefix.
+template<typename Alphabet>
+bool BasicHatTrie<Alphabet>::startsWith(const std::string& prefix) const {
+    size_t depth;
+    const TrieNode* node = descend(prefix, depth);
+    if (!node) {
+        return false;
+    }
+    if (depth == prefix.size()) {
+        return true;
+    }
+
+    std::string_view rest = std::string_view(prefix).substr(depth);
+    std::string_view entry;
+    for (const auto& slot : node->slots) {
+        for (size_t pos = 0; pos < slot.size();) {
+            pos = readPacked(slot, pos, entry);
+            if (entry.compare(0, rest.size(), rest) == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template<typename Alphabet>
+bool BasicHatTrie<Alphabet>::remove(const std::string& word) {
+    std::vector<std::pair<TrieNode*, int>> path;  // parent and code of each step
+    TrieNode* node = root.get();
+    size_t depth = 0;
+
+    while (!node->isContainer && depth < word.size()) {
+        int code = Alphabet::toCode(word[depth]);
+        TrieNode* child = node->children.find(code);
+        if (!child) {
+            return false;
+        }
+        path.push_back({node, code});
+        node = child;
+        depth++;
+    }
+
+    if (depth == word.size()) {
+        if (!node->isEndOfWord) {
+            return false;
+        }
+        node->isEndOfWord = false;
+    } else {
+        std::string_view suffix = std::string_view(word).substr(depth);
+        std::string& slot = node->slots[slotIndex(node, suffix)];
+        size_t pos = findInSlot(slot, suffix);
+        if (pos == std::string::npos) {
+            return false;
+        }
+        erasePacked(slot, pos);
+        node->keyCount--;
+    }
+    wordCount--;
+
+    // Drop nodes left with nothing below them
+    while (!path.empty() && !node->isEndOfWord && node->keyCount == 0 && node->children.empty()) {
+        TrieNode* parent = path.back().first;
+        int code = path.back().second;
+        path.pop_back();
+
+        size_t tableBytes = parent->children.heapBytes();
+        memoryBytes -= sizeof(TrieNode) + containerBytes(node) + node->children.heapBytes();
+        parent->children.erase(code);
+        memoryBytes -= tableBytes - parent->children.heapBytes();
+        nodeCount--;
+        node = parent;
+    }
+    return true;
+}
+
+// Follows trie nodes until the key runs out or a container takes over.
+// Returns null if a branch is missing; depth is the characters consumed.
+template<typename Alphabet>
+const typename BasicHatTrie<Alphabet>::TrieNode*
+BasicHatTrie<Alphabet>::descend(const std::string& key, size_t& depth) const {
+    const TrieNode* node = root.get();
+    depth = 0;
+
+    while (!node->isContainer && depth < key.size()) {
+        node = node->children.find(Alphabet::toCode(key[depth]));
+        if (!node) {
+            break;
+        }
+        depth++;
+    }
+
+    lookups.add(1);
+    nodesVisited.add(depth);
+    return node;
+}
+
+template<typename Alphabet>
+typename BasicHatTrie<Alphabet>::TrieNode* BasicHatTrie<Alphabet>::addChild(TrieNode* node, int code) {
+    size_t tableBytes = node->children.heapBytes();
+    TrieNode* child = node->children.insert(code, std::make_unique<TrieNode>(true));
+    child->slots.resize(INITIAL_SLOTS);
+    nodeCount++;
+    memoryBytes += sizeof(TrieNode) + containerBytes(child) + node->children.heapBytes() - tableBytes;
+    return child;
+}
+
+// Appends suffix to its slot unless it is already there. Returns true if
+// it was added.
+template<typename Alphabet>
+bool BasicHatTrie<Alphabet>::addSuffix(TrieNode* node, std::string_view suffix) {
+    std::string& slot = node->slots[slotIndex(node, suffix)];
+    if (findInSlot(slot, suffix) != std::string::npos) {
+        return false;
+    }
+
+    size_t before = packedHeapBytes(slot);
+    insertPacked(slot, slot.size(), suffix);
+    memoryBytes += packedHeapBytes(slot) - before;
+    node->keyCount++;
+
+    if (node->keyCount > node->slots.size() * MAX_LOAD) {
+        rehash(node, node->slots.size() * 2);
+    }
+    return true;
+}
+
+template<typename Alphabet>
+void BasicHatTrie<Alphabet>::rehash(TrieNode* node, size_t slotCount) {
+    std::vector<std::string> old(slotCount);
+    old.swap(node->slots);
+    memoryBytes += containerBytes(node);
+
+    std::string_view entry;
+    for (auto& slot : old) {
+        memoryBytes -= packedHeapBytes(slot);
+        for (size_t pos = 0; pos < slot.size();) {
+            pos = readPacked(slot, pos, entry);
+            std::string& target = node->slots[slotIndex(node, entry)];
+            size_t before = packedHeapBytes(target);
+            insertPacked(target, target.size(), entry);
+            memoryBytes += packedHeapBytes(target) - before;
+        }
+    }
+    memoryBytes -= old.capacity() * sizeof(std::string);
+}
+
+// The suffixes move, minus their first character, into one new container
+// per character. Any child that received every suffix bursts in turn.
+template<typename Alphabet>
+void BasicHatTrie<Alphabet>::burst(TrieNode* node) {
+    std::vector<std::string> old;
+    memoryBytes -= containerBytes(node);
+    old.swap(node->slots);
+    node->keyCount = 0;
+    node->isContainer = false;
+    bursts.add(1);
+
+    std::string_view entry;
+    for (const auto& slot : old) {
+        for (size_t pos = 0; pos < slot.size();) {
+            pos = readPacked(slot, pos, entry);
+
+            int code = Alphabet::toCode(entry[0]);
+            TrieNode* child = node->children.find(code);
+            if (!child) {
+                child = addChild(node, code);
+            }
+
+            if (entry.size() == 1) {
+                child->isEndOfWord = true;
+            } else {
+                addSuffix(child, entry.substr(1));
+            }
+        }
+    }
+
+    node->children.forEach([this](int, TrieNode* child) {
+        if (child->keyCount >= BURST_THRESHOLD) {
+            burst(child);
+        }
+    });
+}
+
+template<typename Alphabet>
+void BasicHatTrie<Alphabet>::rangeScan(const std::string& lo, const std::string& hi,
+                                       const KeyCallback& onKey) const {
+    std::string word;
+    rangeScanHelper(root.get(), true, lo, hi, word, onKey);
+}
+
+template<typename Alphabet>
+void BasicHatTrie<Alphabet>::prefixScan(const std::string& prefix, const KeyCallback& onKey) const {
+    rangeScan(prefix, "", [&](const std::string& key) {
+        return key.compare(0, prefix.size(), prefix) == 0 && onKey(key);
+    });
+}
+
+// tight: word is still a prefix of lo, so only children at or after
+// lo[depth] (or suffixes at or after the rest of lo) can hold keys in
+// range. Returns false once the scan is over.
+template<typename Alphabet>
+bool BasicHatTrie<Alphabet>::rangeScanHelper(const TrieNode* node, bool tight, const std::string& lo,
+                                             const std::string& hi, std::string& word,
+                                             const KeyCallback& onKey) const {
+    // every key below this node is >= word
+    if (!hi.empty() && word >= hi) {
+        return false;
+    }
+
+    size_t depth = word.size();
+    if (tight && depth == lo.size()) {
+        tight = false;
+    }
+
+    if (!tight && node->isEndOfWord && !onKey(word)) {
+        return false;
+    }
+
+    if (node->isContainer) {
+        std::string_view loRest = tight ? std::string_view(lo).substr(depth) : std::string_view();
+        std::vector<std::string_view> entries;
+        entries.reserve(node->keyCount);
+
+        std::string_view entry;
+        for (const auto& slot : node->slots) {
+            for (size_t pos = 0; pos < slot.size();) {
+                pos = readPacked(slot, pos, entry);
+                if (entry >= loRest) {
+                    entries.push_back(entry);
+                }
+            }
+        }
+        std::sort(entries.begin(), entries.end());
+
+        for (std::string_view suffix : entries) {
+            word.append(suffix);
+            bool more = (hi.empty() || word < hi) && onKey(word);
+            word.resize(depth);
+            if (!more) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int loCode = tight ? Alphabet::toCode(lo[depth]) : -1;
+    int firstCode = tight ? lowerBoundCode<Alphabet>(lo[depth]) : 0;
+
+    return node->children.forEachFrom(firstCode, [&](int code, const TrieNode* child) {
+        word.push_back(Alphabet::toChar(code));
+        bool more = rangeScanHelper(child, code == loCode, lo, hi, word, onKey);
+        word.pop_back();
+        return more;
+    });
+}
+
+template<typename Alphabet>
+size_t BasicHatTrie<Alphabet>::containerBytes(const TrieNode* node) {
+    size_t bytes = node->slots.capacity() * sizeof(std::string);
+    for (const auto& slot : node->slots) {
+        bytes += packedHeapBytes(slot);
+    }
+    return bytes;
+}
+
+template<typename Alphabet>
+size_t BasicHatTrie<Alphabet>::slotIndex(const TrieNode* node, std::string_view suffix) {
+    return std::hash<std::string_view>()(suffix) & (node->slots.size() - 1);
+}
+
+// Position of suffix in the slot, npos if absent. The length byte rejects
+// most entries before their bytes are compared.
+template<typename Alphabet>
+size_t BasicHatTrie<Alphabet>::findInSlot(const std::string& slot, std::string_view suffix) {
+    std::string_view entry;
+    for (size_t pos = 0; pos < slot.size();) {
+        size_t next = readPacked(slot, pos, entry);
+        if (entry == suffix) {
+            return pos;
+        }
+        pos = next;
+    }
+    return std::string::npos;
+}
+
+template<typename Alphabet>
+TrieStats BasicHatTrie<Alphabet>::stats() const {
+    TrieStats snapshot;
+    snapshot.memoryBytes = memoryBytes;
+    snapshot.nodes = nodeCount;
+    snapshot.words = wordCount;
+    snapshot.bursts = bursts.get();
+    snapshot.lookups = lookups.get();
+    snapshot.nodesVisited = nodesVisited.get();
+    return snapshot;
+}
+
+template<typename Alphabet>
+void BasicHatTrie<Alphabet>::clear() {
+    root = std::make_unique<TrieNode>(false);
+    wordCount = 0;
+    nodeCount = 1;
+    memoryBytes = sizeof(TrieNode);
+    bursts.reset();
+    lookups.reset();
+    nodesVisited.reset();
+}
+
+template<typename Alphabet>
+std::vector<std::string> BasicHatTrie<Alphabet>::getAllWords() const {
+    std::vector<std::string> words;
+    rangeScan("", "", [&words](const std::string& key) {
+        words.push_back(key);
+        return true;
+    });
+    return words;
+}
+
+// Explicit template instantiations
+template class BasicHatTrie<ByteAlphabet>;
+template class BasicHatTrie<LowercaseAlphabet>;
+template class BasicHatTrie<DnaAlphabet>;
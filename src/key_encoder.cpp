@@ -0,0 +1,242 @@
+#include "key_encoder.h"
+#include <algorithm>
+#include <numeric>
+#include <set>
+#include <unordered_map>
+
+// Smallest string greater than every string that starts with s, or empty
+// (meaning +infinity) when s is all 0xff bytes
+static std::string successor(std::string s) {
+    while (!s.empty() && static_cast<unsigned char>(s.back()) == 0xff) {
+        s.pop_back();
+    }
+    if (!s.empty()) {
+        s.back() = static_cast<char>(static_cast<unsigned char>(s.back()) + 1);
+    }
+    return s;
+}
+
+void KeyEncoder::train(const std::vector<std::string>& sample, size_t symbols, size_t maxGram) {
+    clear();
+    symbols = std::min(symbols, MAX_SYMBOLS);
+    maxGram = std::min<size_t>(maxGram, 255);
+
+    // Count n-grams one length at a time. A gram is only counted when the
+    // gram one byte shorter survived the previous round, which keeps the
+    // tables near `symbols` entries however long maxGram is.
+    using Gram = std::pair<std::string_view, size_t>;
+    std::vector<Gram> candidates;
+    std::unordered_map<std::string_view, size_t> previous;
+
+    for (size_t length = 2; length <= maxGram; length++) {
+        std::unordered_map<std::string_view, size_t> counts;
+        for (const auto& key : sample) {
+            for (size_t pos = 0; pos + length <= key.size(); pos++) {
+                std::string_view gram(key.data() + pos, length);
+                if (length > 2 && previous.count(gram.substr(0, length - 1)) == 0) {
+                    continue;
+                }
+                counts[gram]++;
+            }
+        }
+
+        std::vector<Gram> level;
+        for (const auto& entry : counts) {
+            if (entry.second > 1) {
+                level.push_back(entry);
+            }
+        }
+        auto moreFrequent = [](const Gram& a, const Gram& b) {
+            return a.second != b.second ? a.second > b.second : a.first < b.first;
+        };
+        if (level.size() > symbols) {
+            std::partial_sort(level.begin(), level.begin() + symbols, level.end(), moreFrequent);
+            level.resize(symbols);
+        }
+        if (level.empty()) {
+            break;
+        }
+
+        previous.clear();
+        previous.insert(level.begin(), level.end());
+        candidates.insert(candidates.end(), level.begin(), level.end());
+    }
+
+    // Keep the grams that would save the most bytes
+    auto moreSaved = [](const Gram& a, const Gram& b) {
+        size_t savedA = a.second * (a.first.size() - 1), savedB = b.second * (b.first.size() - 1);
+        return savedA != savedB ? savedA > savedB : a.first < b.first;
+    };
+    std::sort(candidates.begin(), candidates.end(), moreSaved);
+    if (candidates.size() > symbols) {
+        candidates.resize(symbols);
+    }
+
+    // Every single byte is a symbol, so any key can be encoded. Each
+    // symbol s opens an interval at s and one at successor(s), where
+    // strings stop starting with s.
+    std::vector<std::string> bounds;
+    for (int c = 0; c < 256; c++) {
+        bounds.emplace_back(1, static_cast<char>(c));
+    }
+    for (const auto& candidate : candidates) {
+        std::string symbol(candidate.first);
+        std::string next = successor(symbol);
+        if (!next.empty()) {
+            bounds.push_back(next);
+        }
+        bounds.push_back(std::move(symbol));
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    // An interval's symbol is the longest prefix of its lower bound that
+    // every string up to the next bound shares. Length 1 always qualifies
+    // because the next single byte is itself a bound.
+    intervals.resize(bounds.size());
+    for (size_t i = 0; i < bounds.size(); i++) {
+        Interval& interval = intervals[i];
+        size_t length = bounds[i].size();
+        for (; length > 1; length--) {
+            std::string end = successor(bounds[i].substr(0, length));
+            if (end.empty() || (i + 1 < bounds.size() && bounds[i + 1] <= end)) {
+                break;
+            }
+        }
+        interval.lower = std::move(bounds[i]);
+        interval.symbolLength = static_cast<uint16_t>(length);
+        if (interval.lower.size() == 1) {
+            firstInterval[static_cast<unsigned char>(interval.lower[0])] = static_cast<uint32_t>(i);
+        }
+    }
+    firstInterval[256] = static_cast<uint32_t>(intervals.size());
+
+    // Short codes go to the intervals the sample actually lands in
+    std::vector<size_t> uses(intervals.size(), 0);
+    for (const auto& key : sample) {
+        std::string_view rest(key);
+        while (!rest.empty()) {
+            const Interval& interval = locate(rest);
+            uses[&interval - intervals.data()]++;
+            rest.remove_prefix(interval.symbolLength);
+        }
+    }
+    assignCodes(uses);
+}
+
+// There are 256 first bytes. An interval with a one-byte code uses one
+// up; the rest fill two-byte blocks of up to 256 consecutive intervals,
+// one first byte per block. Promoting an interval splits the run it sits
+// in, so the cost is recomputed for each candidate, most used first.
+void KeyEncoder::assignCodes(const std::vector<size_t>& uses) {
+    size_t count = intervals.size();
+    auto blocks = [](size_t run) { return (run + 255) / 256; };
+
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&uses](size_t a, size_t b) { return uses[a] > uses[b]; });
+
+    std::set<size_t> singles;
+    size_t firstBytes = blocks(count);
+    for (size_t i : order) {
+        if (uses[i] == 0) {
+            break;
+        }
+        auto next = singles.upper_bound(i);
+        size_t runEnd = next == singles.end() ? count : *next;
+        size_t runStart = next == singles.begin() ? 0 : *std::prev(next) + 1;
+        size_t needed = firstBytes + 1 + blocks(i - runStart) + blocks(runEnd - i - 1) - blocks(runEnd - runStart);
+        if (needed <= 256) {
+            singles.insert(i);
+            firstBytes = needed;
+        }
+    }
+
+    uint16_t first = 0;
+    for (size_t i = 0; i < count; first++) {
+        if (singles.count(i)) {
+            intervals[i].code = first;
+            intervals[i].codeLength = 1;
+            decodeTable[first] = {static_cast<uint32_t>(i), false};
+            i++;
+            continue;
+        }
+        decodeTable[first] = {static_cast<uint32_t>(i), true};
+        for (uint16_t second = 0; second < 256 && i < count && !singles.count(i); second++, i++) {
+            intervals[i].code = static_cast<uint16_t>(first << 8 | second);
+            intervals[i].codeLength = 2;
+        }
+    }
+}
+
+// Last interval whose lower bound is <= rest. Bounds starting with rest's
+// first byte sit between that byte's single-byte bound and the next one.
+const KeyEncoder::Interval& KeyEncoder::locate(std::string_view rest) const {
+    unsigned char c = static_cast<unsigned char>(rest[0]);
+    auto first = intervals.begin() + firstInterval[c];
+    auto last = intervals.begin() + firstInterval[c + 1];
+    auto it = std::upper_bound(first + 1, last, rest, [](std::string_view key, const Interval& interval) {
+        return key < std::string_view(interval.lower);
+    });
+    return *(it - 1);
+}
+
+std::string KeyEncoder::encode(std::string_view key) const {
+    std::string out;
+    encode(key, out);
+    return out;
+}
+
+void KeyEncoder::encode(std::string_view key, std::string& out) const {
+    if (!isTrained()) {
+        out.append(key);
+        return;
+    }
+
+    while (!key.empty()) {
+        const Interval& interval = locate(key);
+        if (interval.codeLength == 2) {
+            out += static_cast<char>(interval.code >> 8);
+        }
+        out += static_cast<char>(interval.code & 0xff);
+        key.remove_prefix(interval.symbolLength);
+    }
+}
+
+std::string KeyEncoder::decode(std::string_view code) const {
+    if (!isTrained()) {
+        return std::string(code);
+    }
+
+    std::string key;
+    size_t pos = 0;
+    while (pos < code.size()) {
+        const DecodeEntry& entry = decodeTable[static_cast<unsigned char>(code[pos++])];
+        size_t index = entry.interval;
+        if (entry.twoByte) {
+            if (pos == code.size()) {
+                break;
+            }
+            index += static_cast<unsigned char>(code[pos++]);
+        }
+        key.append(intervals[index].lower, 0, intervals[index].symbolLength);
+    }
+    return key;
+}
+
+size_t KeyEncoder::getMemoryUsage() const {
+    size_t bytes = sizeof(*this) + intervals.capacity() * sizeof(Interval);
+    const size_t inlineCapacity = std::string().capacity();
+    for (const auto& interval : intervals) {
+        if (interval.lower.capacity() > inlineCapacity) {
+            bytes += interval.lower.capacity() + 1;
+        }
+    }
+    return bytes;
+}
+
+void KeyEncoder::clear() {
+    intervals.clear();
+    firstInterval.fill(0);
+    decodeTable.fill({0, false});
+}
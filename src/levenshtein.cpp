@@ -0,0 +1,47 @@
+#include "levenshtein.h"
+#include <algorithm>
+
+LevenshteinAutomaton::LevenshteinAutomaton(const std::string& query, int maxDistance)
+    : query(query), maxDistance(std::max(maxDistance, 0)) {}
+
+void LevenshteinAutomaton::start(int* row) const {
+    for (size_t j = 0; j <= query.size(); j++) {
+        row[j] = static_cast<int>(j);
+    }
+}
+
+int LevenshteinAutomaton::step(const int* prev, int* next, char c, size_t depth) const {
+    const int outside = maxDistance + 1;
+    const size_t n = query.size();
+
+    // band of query positions that can still be within maxDistance
+    size_t lo = depth > static_cast<size_t>(maxDistance) ? depth - maxDistance : 0;
+    size_t hi = std::min(n, depth + maxDistance);
+
+    if (lo > n) {
+        // candidate is already longer than the query plus the bound
+        std::fill(next, next + n + 1, outside);
+        return outside;
+    }
+
+    std::fill(next, next + lo, outside);
+
+    int rowMin = outside;
+    for (size_t j = lo; j <= hi; j++) {
+        int value;
+        if (j == 0) {
+            value = static_cast<int>(depth);
+        } else {
+            int substitute = prev[j - 1] + (query[j - 1] == c ? 0 : 1);
+            int insert = prev[j] + 1;
+            int remove = next[j - 1] + 1;
+            value = std::min({substitute, insert, remove});
+        }
+        value = std::min(value, outside);
+        next[j] = value;
+        rowMin = std::min(rowMin, value);
+    }
+
+    std::fill(next + hi + 1, next + n + 1, outside);
+    return rowMin;
+}
@@ -1,109 +1,423 @@
 #include "standard_trie.h"
+#include <queue>
+#include <utility>
 
-StandardTrie::StandardTrie() : wordCount(0), nodeCount(1) {
+template<typename Alphabet>
+BasicStandardTrie<Alphabet>::BasicStandardTrie() : wordCount(0), nodeCount(1), memoryBytes(sizeof(TrieNode)) {
     root = std::make_unique<TrieNode>();
 }
 
-void StandardTrie::insert(const std::string& word) {
+template<typename Alphabet>
+void BasicStandardTrie<Alphabet>::insert(const std::string& word) {
+    if (!isValidKey<Alphabet>(word)) return;
+
     TrieNode* current = root.get();
-    
+
     for (char c : word) {
-        if (current->children.find(c) == current->children.end()) {
-            current->children[c] = std::make_unique<TrieNode>();
+        int code = Alphabet::toCode(c);
+        TrieNode* child = current->children.find(code);
+        if (!child) {
+            size_t tableBytes = current->children.heapBytes();
+            child = current->children.insert(code, std::make_unique<TrieNode>());
             nodeCount++;
+            memoryBytes += sizeof(TrieNode) + current->children.heapBytes() - tableBytes;
         }
-        current = current->children[c].get();
+        current = child;
     }
-    
+
     if (!current->isEndOfWord) {
         current->isEndOfWord = true;
         wordCount++;
+        addToCounts(word, 1);
     }
 }
 
-bool StandardTrie::search(const std::string& word) const {
-    const TrieNode* current = root.get();
-    
+template<typename Alphabet>
+bool BasicStandardTrie<Alphabet>::search(const std::string& word) const {
+    const TrieNode* node = findNode(word);
+    return node && node->isEndOfWord;
+}
+
+// remove() leaves emptied nodes in place, so a path alone is not enough
+template<typename Alphabet>
+bool BasicStandardTrie<Alphabet>::startsWith(const std::string& prefix) const {
+    const TrieNode* node = findNode(prefix);
+    return node && node->wordsBelow > 0;
+}
+
+template<typename Alphabet>
+bool BasicStandardTrie<Alphabet>::remove(const std::string& word) {
+    // Not through findNode(), which would count a lookup
+    TrieNode* current = root.get();
     for (char c : word) {
-        auto it = current->children.find(c);
-        if (it == current->children.end()) {
+        current = current->children.find(Alphabet::toCode(c));
+        if (!current) {
             return false;
         }
-        current = it->second.get();
     }
-    
-    return current->isEndOfWord;
+    if (!current->isEndOfWord) {
+        return false;
+    }
+
+    // Simple approach: just unmark the end of word
+    // Full deletion with node removal would be more complex
+
+    current->isEndOfWord = false;
+    wordCount--;
+    addToCounts(word, -1);
+    return true;
+}
+
+// Adjusts wordsBelow on every node from the root to the end of key,
+// which must all exist
+template<typename Alphabet>
+void BasicStandardTrie<Alphabet>::addToCounts(const std::string& key, int delta) {
+    TrieNode* current = root.get();
+    current->wordsBelow += delta;
+    for (char c : key) {
+        current = current->children.find(Alphabet::toCode(c));
+        current->wordsBelow += delta;
+    }
 }
 
-bool StandardTrie::startsWith(const std::string& prefix) const {
+template<typename Alphabet>
+const typename BasicStandardTrie<Alphabet>::TrieNode*
+BasicStandardTrie<Alphabet>::findNode(const std::string& key) const {
     const TrieNode* current = root.get();
-    
-    for (char c : prefix) {
-        auto it = current->children.find(c);
-        if (it == current->children.end()) {
-            return false;
+    size_t visited = 0;
+
+    for (char c : key) {
+        current = current->children.find(Alphabet::toCode(c));
+        if (!current) {
+            break;
         }
-        current = it->second.get();
+        visited++;
     }
-    
-    return true;
+
+    lookups.add(1);
+    nodesVisited.add(visited);
+    return current;
+}
+
+template<typename Alphabet>
+size_t BasicStandardTrie<Alphabet>::longestPrefixMatch(std::string_view input) const {
+    const TrieNode* current = root.get();
+    size_t longest = 0;
+
+    for (size_t i = 0; i < input.size(); i++) {
+        current = current->children.find(Alphabet::toCode(input[i]));
+        if (!current) {
+            break;
+        }
+        if (current->isEndOfWord) {
+            longest = i + 1;
+        }
+    }
+
+    return longest;
+}
+
+template<typename Alphabet>
+void BasicStandardTrie<Alphabet>::rangeScan(const std::string& lo, const std::string& hi,
+                                            const KeyCallback& onKey) const {
+    std::string word;
+    rangeScanHelper(root.get(), true, lo, hi, word, onKey);
 }
 
-bool StandardTrie::remove(const std::string& word) {
-    if (!search(word)) {
+// tight: word is still a prefix of lo, so only children at or after
+// lo[depth] can hold keys in range. Returns false once the scan is over.
+template<typename Alphabet>
+bool BasicStandardTrie<Alphabet>::rangeScanHelper(const TrieNode* node, bool tight, const std::string& lo,
+                                                  const std::string& hi, std::string& word,
+                                                  const KeyCallback& onKey) const {
+    // every key below this node is >= word
+    if (!hi.empty() && word >= hi) {
         return false;
     }
-    
-    // Simple approach: just unmark the end of word
-    // Full deletion with node removal would be more complex
-    TrieNode* current = root.get();
-    for (char c : word) {
-        current = current->children[c].get();
+
+    size_t depth = word.size();
+    if (tight && depth == lo.size()) {
+        tight = false;
     }
-    
-    current->isEndOfWord = false;
-    wordCount--;
-    return true;
+
+    if (!tight && node->isEndOfWord && !onKey(word)) {
+        return false;
+    }
+
+    int loCode = tight ? Alphabet::toCode(lo[depth]) : -1;
+    int firstCode = tight ? lowerBoundCode<Alphabet>(lo[depth]) : 0;
+
+    return node->children.forEachFrom(firstCode, [&](int code, const TrieNode* child) {
+        word.push_back(Alphabet::toChar(code));
+        bool more = rangeScanHelper(child, code == loCode, lo, hi, word, onKey);
+        word.pop_back();
+        return more;
+    });
 }
 
-size_t StandardTrie::getMemoryUsage() const {
-    return calculateMemoryUsage(root.get());
+template<typename Alphabet>
+size_t BasicStandardTrie<Alphabet>::countPrefix(const std::string& prefix) const {
+    const TrieNode* node = findNode(prefix);
+    return node ? node->wordsBelow : 0;
 }
 
-size_t StandardTrie::calculateMemoryUsage(const TrieNode* node) const {
-    if (!node) return 0;
-    
-    size_t total = sizeof(TrieNode);
-    total += node->children.size() * (sizeof(char) + sizeof(std::unique_ptr<TrieNode>));
-    
-    for (const auto& [c, child] : node->children) {
-        total += calculateMemoryUsage(child.get());
+// Walks down key; every key ending on the way (a proper prefix of key)
+// and every subtree under a smaller sibling sorts before it
+template<typename Alphabet>
+size_t BasicStandardTrie<Alphabet>::rank(const std::string& key) const {
+    const TrieNode* current = root.get();
+    size_t below = 0;
+
+    for (char c : key) {
+        if (current->isEndOfWord) {
+            below++;
+        }
+
+        int code = Alphabet::toCode(c);
+        int limit = code >= 0 ? code : lowerBoundCode<Alphabet>(c);
+        const TrieNode* next = nullptr;
+        current->children.forEachFrom(0, [&](int childCode, const TrieNode* child) {
+            if (childCode >= limit) {
+                next = childCode == code ? child : nullptr;
+                return false;
+            }
+            below += child->wordsBelow;
+            return true;
+        });
+
+        if (!next) {
+            return below;
+        }
+        current = next;
     }
-    
-    return total;
+
+    return below;
 }
 
-void StandardTrie::clear() {
+template<typename Alphabet>
+std::string BasicStandardTrie<Alphabet>::select(size_t index) const {
+    if (index >= wordCount) {
+        return "";
+    }
+
+    const TrieNode* current = root.get();
+    std::string word;
+
+    while (true) {
+        if (current->isEndOfWord) {
+            if (index == 0) {
+                return word;
+            }
+            index--;
+        }
+
+        current->children.forEachFrom(0, [&](int code, const TrieNode* child) {
+            if (index < child->wordsBelow) {
+                word.push_back(Alphabet::toChar(code));
+                current = child;
+                return false;
+            }
+            index -= child->wordsBelow;
+            return true;
+        });
+    }
+}
+
+template<typename Alphabet>
+std::vector<FuzzyMatch> BasicStandardTrie<Alphabet>::fuzzySearch(const std::string& query,
+                                                                 int maxDistance) const {
+    std::vector<FuzzyMatch> matches;
+    LevenshteinAutomaton automaton(query, maxDistance);
+
+    // one DP row per depth of the current path
+    std::vector<int> rows(automaton.rowSize());
+    automaton.start(rows.data());
+
+    std::string word;
+    fuzzySearchHelper(root.get(), automaton, rows, word, matches);
+    return matches;
+}
+
+template<typename Alphabet>
+void BasicStandardTrie<Alphabet>::fuzzySearchHelper(const TrieNode* node, const LevenshteinAutomaton& automaton,
+                                                    std::vector<int>& rows, std::string& word,
+                                                    std::vector<FuzzyMatch>& matches) const {
+    size_t rowSize = automaton.rowSize();
+    size_t depth = word.size();
+
+    if (node->isEndOfWord && automaton.isMatch(&rows[depth * rowSize])) {
+        matches.push_back({word, automaton.distance(&rows[depth * rowSize])});
+    }
+
+    if (rows.size() < (depth + 2) * rowSize) {
+        rows.resize((depth + 2) * rowSize);
+    }
+
+    node->children.forEach([&](int code, const TrieNode* child) {
+        char c = Alphabet::toChar(code);
+        int rowMin = automaton.step(&rows[depth * rowSize], &rows[(depth + 1) * rowSize], c, depth + 1);
+        if (automaton.isDead(rowMin)) {
+            return;  // prune the whole subtree
+        }
+
+        word.push_back(c);
+        fuzzySearchHelper(child, automaton, rows, word, matches);
+        word.pop_back();
+    });
+}
+
+template<typename Alphabet>
+std::vector<std::string> BasicStandardTrie<Alphabet>::matchPattern(const std::string& pattern) const {
+    std::vector<std::string> matches;
+    GlobPattern glob(pattern);
+
+    // one NFA state set per depth of the current path
+    std::vector<uint64_t> states(glob.stateWords());
+    glob.start(states.data());
+
+    std::string word;
+    matchPatternHelper(root.get(), glob, states, word, matches);
+    return matches;
+}
+
+template<typename Alphabet>
+void BasicStandardTrie<Alphabet>::matchPatternHelper(const TrieNode* node, const GlobPattern& glob,
+                                                     std::vector<uint64_t>& states, std::string& word,
+                                                     std::vector<std::string>& matches) const {
+    size_t width = glob.stateWords();
+    size_t depth = word.size();
+
+    if (node->isEndOfWord && glob.isMatch(&states[depth * width])) {
+        matches.push_back(word);
+    }
+
+    int forced = glob.forcedChar(&states[depth * width]);
+    if (forced == GlobPattern::NO_CHAR) {
+        return;
+    }
+
+    if (states.size() < (depth + 2) * width) {
+        states.resize((depth + 2) * width);
+    }
+
+    auto visit = [&](char c, const TrieNode* child) {
+        if (glob.step(&states[depth * width], &states[(depth + 1) * width], c)) {
+            word.push_back(c);
+            matchPatternHelper(child, glob, states, word, matches);
+            word.pop_back();
+        }
+    };
+
+    if (forced != GlobPattern::ANY_CHAR) {
+        // literal next character - follow just that child
+        char c = static_cast<char>(forced);
+        const TrieNode* child = node->children.find(Alphabet::toCode(c));
+        if (child) {
+            visit(c, child);
+        }
+        return;
+    }
+
+    node->children.forEach([&](int code, const TrieNode* child) {
+        visit(Alphabet::toChar(code), child);
+    });
+}
+
+template<typename Alphabet>
+TrieStats BasicStandardTrie<Alphabet>::stats() const {
+    TrieStats snapshot;
+    snapshot.memoryBytes = memoryBytes;
+    snapshot.nodes = nodeCount;
+    snapshot.words = wordCount;
+    snapshot.lookups = lookups.get();
+    snapshot.nodesVisited = nodesVisited.get();
+    return snapshot;
+}
+
+// Branches left without keys by remove are not copied
+template<typename Alphabet>
+BasicDoubleArrayTrie<Alphabet> BasicStandardTrie<Alphabet>::freeze() const {
+    BasicDoubleArrayTrie<Alphabet> frozen;
+    std::queue<std::pair<const TrieNode*, int>> pending;  // node and its state
+    pending.push({root.get(), 0});
+    std::vector<int> codes;
+
+    while (!pending.empty()) {
+        auto [node, state] = pending.front();
+        pending.pop();
+
+        codes.clear();
+        node->children.forEach([&codes](int code, const TrieNode* child) {
+            if (child->wordsBelow > 0) {
+                codes.push_back(code);
+            }
+        });
+
+        if (!codes.empty()) {
+            int childBase = frozen.placeChildren(state, codes);
+            node->children.forEach([&](int code, const TrieNode* child) {
+                if (child->wordsBelow > 0) {
+                    pending.push({child, childBase + code});
+                }
+            });
+        }
+
+        if (node->isEndOfWord && state != 0) {
+            frozen.markEndOfWord(state);
+        }
+    }
+
+    frozen.compact();
+    return frozen;
+}
+
+template<typename Alphabet>
+BasicFlatTrie<Alphabet> BasicStandardTrie<Alphabet>::relayout() const {
+    BasicFlatTrie<Alphabet> flat;
+    flat.build(root.get(), [](const void* source, auto& out) {
+        const TrieNode* node = static_cast<const TrieNode*>(source);
+        out.isEndOfWord = node->isEndOfWord;
+        node->children.forEach([&out](int code, const TrieNode* child) {
+            if (child->wordsBelow > 0) {
+                out.children.push_back({code, child});
+            }
+        });
+    });
+    return flat;
+}
+
+template<typename Alphabet>
+void BasicStandardTrie<Alphabet>::clear() {
     root = std::make_unique<TrieNode>();
     wordCount = 0;
     nodeCount = 1;
+    memoryBytes = sizeof(TrieNode);
+    lookups.reset();
+    nodesVisited.reset();
 }
 
-std::vector<std::string> StandardTrie::getAllWords() const {
+template<typename Alphabet>
+std::vector<std::string> BasicStandardTrie<Alphabet>::getAllWords() const {
     std::vector<std::string> words;
     getAllWordsHelper(root.get(), "", words);
     return words;
 }
 
-void StandardTrie::getAllWordsHelper(const TrieNode* node, std::string currentWord, 
-                                     std::vector<std::string>& words) const {
+template<typename Alphabet>
+void BasicStandardTrie<Alphabet>::getAllWordsHelper(const TrieNode* node, std::string currentWord,
+                                                    std::vector<std::string>& words) const {
     if (!node) return;
-    
+
     if (node->isEndOfWord) {
         words.push_back(currentWord);
     }
-    
-    for (const auto& [c, child] : node->children) {
-        getAllWordsHelper(child.get(), currentWord + c, words);
-    }
+
+    node->children.forEach([&](int code, const TrieNode* child) {
+        getAllWordsHelper(child, currentWord + Alphabet::toChar(code), words);
+    });
 }
+
+// Explicit template instantiations
+template class BasicStandardTrie<ByteAlphabet>;
+template class BasicStandardTrie<LowercaseAlphabet>;
+template class BasicStandardTrie<DnaAlphabet>;
@@ -0,0 +1,96 @@
+#ifndef TESTS_CHECK_H
+#define TESTS_CHECK_H
+
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+// Shared by the programs in tests/. Each one builds a structure and a
+// std::set from the same keys and checks that they agree. CHECK reports
+// a failure and carries on, so one run lists every broken case, and
+// finish() turns the failure count into the exit status for make test.
+
+using Oracle = std::set<std::string>;
+
+inline int& checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                       \
+    do {                                                                                       \
+        if (!(condition)) {                                                                    \
+            checkFailures()++;                                                                 \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed\n";    \
+        }                                                                                      \
+    } while (0)
+
+inline int finish(const char* name) {
+    if (checkFailures() == 0) {
+        std::cout << name << ": ok\n";
+        return 0;
+    }
+    std::cout << name << ": " << checkFailures() << " failed checks\n";
+    return 1;
+}
+
+// Keys over the characters [first, last] of 1 to maxLength characters
+// (not every structure stores the empty key, so tests add it themselves).
+// A small range and short keys make shared prefixes, keys that are
+// prefixes of other keys and repeats common.
+inline std::vector<std::string> randomKeys(std::mt19937& rng, size_t count, char first, char last,
+                                           size_t maxLength) {
+    std::uniform_int_distribution<int> charDist(first, last);
+    std::uniform_int_distribution<size_t> lengthDist(1, maxLength);
+
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        std::string key(lengthDist(rng), ' ');
+        for (char& c : key) {
+            c = static_cast<char>(charDist(rng));
+        }
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+// Every key rangeScan(lo, hi) reports, in the order it reports them
+template<typename OrderedType>
+std::vector<std::string> scanRange(const OrderedType& keys, const std::string& lo, const std::string& hi) {
+    std::vector<std::string> found;
+    keys.rangeScan(lo, hi, [&found](const std::string& key) {
+        found.push_back(key);
+        return true;
+    });
+    return found;
+}
+
+// What a range scan should report: the oracle's keys in [lo, hi)
+inline std::vector<std::string> expectedRange(const Oracle& oracle, const std::string& lo, const std::string& hi) {
+    if (!hi.empty() && hi <= lo) {
+        return {};
+    }
+    auto end = hi.empty() ? oracle.end() : oracle.lower_bound(hi);
+    return std::vector<std::string>(oracle.lower_bound(lo), end);
+}
+
+// True if some oracle key starts with prefix
+inline bool oracleHasPrefix(const Oracle& oracle, const std::string& prefix) {
+    auto it = oracle.lower_bound(prefix);
+    return it != oracle.end() && it->compare(0, prefix.size(), prefix) == 0;
+}
+
+// search and startsWith answer what the oracle does for every probe
+template<typename TrieType>
+void checkLookups(const TrieType& trie, const Oracle& oracle, const std::vector<std::string>& probes) {
+    CHECK(trie.getWordCount() == oracle.size());
+    for (const auto& probe : probes) {
+        CHECK(trie.search(probe) == (oracle.count(probe) > 0));
+        CHECK(trie.startsWith(probe) == oracleHasPrefix(oracle, probe));
+    }
+}
+
+#endif
@@ -0,0 +1,74 @@
+#include "check.h"
+#include "aho_corasick.h"
+#include <algorithm>
+#include <utility>
+
+using Matches = std::vector<std::pair<size_t, size_t>>;  // (start, length)
+
+// Every occurrence of every pattern, by comparing at each offset
+static Matches expectedMatches(const Oracle& patterns, const std::string& text) {
+    Matches matches;
+    for (size_t start = 0; start < text.size(); start++) {
+        for (const auto& pattern : patterns) {
+            if (text.compare(start, pattern.size(), pattern) == 0) {
+                matches.emplace_back(start, pattern.size());
+            }
+        }
+    }
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+template<typename MatcherType>
+void checkMatcher(const std::vector<std::string>& patterns, const std::string& text, std::mt19937& rng) {
+    MatcherType matcher;
+    Oracle oracle;
+    for (const auto& pattern : patterns) {
+        matcher.insert(pattern);
+        oracle.insert(pattern);
+    }
+    matcher.build();
+    CHECK(matcher.isBuilt());
+    CHECK(matcher.getWordCount() == oracle.size());
+
+    Matches expected = expectedMatches(oracle, text);
+    CHECK(!expected.empty());
+
+    Matches whole;
+    matcher.scan(text, [&whole](size_t start, size_t length) { whole.emplace_back(start, length); });
+    std::sort(whole.begin(), whole.end());
+    CHECK(whole == expected);
+
+    // The same text in random pieces, so matches straddle the boundaries
+    Matches streamed;
+    typename MatcherType::StreamState stream;
+    for (size_t pos = 0; pos < text.size();) {
+        size_t piece = std::min<size_t>(rng() % 9, text.size() - pos);
+        matcher.scan(text.data() + pos, piece, stream,
+                     [&streamed](size_t start, size_t length) { streamed.emplace_back(start, length); });
+        pos += piece;
+    }
+    std::sort(streamed.begin(), streamed.end());
+    CHECK(streamed == expected);
+}
+
+int main() {
+    std::mt19937 rng(30);
+
+    // Patterns that are suffixes and infixes of each other
+    auto patterns = randomKeys(rng, 150, 'a', 'c', 5);
+    patterns.insert(patterns.end(), {"a", "aa", "aaa", "abcab", "bca", "cab"});
+    std::string text;
+    for (const auto& piece : randomKeys(rng, 400, 'a', 'd', 6)) {
+        text += piece;
+    }
+
+    checkMatcher<AhoCorasick>(patterns, text, rng);
+    checkMatcher<BasicAhoCorasick<LowercaseAlphabet>>(patterns, text, rng);
+
+    // Text characters outside the alphabet reset the scan
+    std::string dnaText = "ACGTTGCA!ACGNNACGT";
+    checkMatcher<BasicAhoCorasick<DnaAlphabet>>({"ACG", "CGT", "GCA", "T", "TT"}, dnaText, rng);
+
+    return finish("aho_corasick");
+}
@@ -0,0 +1,93 @@
+#include "check.h"
+#include "alphabet.h"
+#include "compressed_trie.h"
+#include "double_array_trie.h"
+#include "standard_trie.h"
+
+// Keys mixing alphabet and non-alphabet characters. Only the valid ones
+// go into the oracle, since the tries drop the rest on insert.
+template<typename TrieType, typename AlphabetType>
+void checkTrie(const std::vector<std::string>& keys, const std::vector<std::string>& probes) {
+    TrieType trie;
+    Oracle oracle;
+    for (const auto& key : keys) {
+        trie.insert(key);
+        if (isValidKey<AlphabetType>(key)) {
+            oracle.insert(key);
+        }
+    }
+
+    checkLookups(trie, oracle, probes);
+    CHECK(scanRange(trie, "", "") == expectedRange(oracle, "", ""));
+}
+
+template<typename AlphabetType>
+void checkCodes() {
+    for (int code = 0; code < AlphabetType::size; code++) {
+        CHECK(AlphabetType::toCode(AlphabetType::toChar(code)) == code);
+        if (code > 0) {
+            // code order is character order
+            CHECK(static_cast<unsigned char>(AlphabetType::toChar(code - 1)) <
+                  static_cast<unsigned char>(AlphabetType::toChar(code)));
+        }
+    }
+
+    // lowerBoundCode is the first code whose character is >= c
+    for (int c = 0; c < 256; c++) {
+        int expected = AlphabetType::size;
+        for (int code = 0; code < AlphabetType::size; code++) {
+            if (static_cast<unsigned char>(AlphabetType::toChar(code)) >= c) {
+                expected = code;
+                break;
+            }
+        }
+        CHECK(lowerBoundCode<AlphabetType>(static_cast<char>(c)) == expected);
+    }
+}
+
+int main() {
+    checkCodes<ByteAlphabet>();
+    checkCodes<LowercaseAlphabet>();
+    checkCodes<DnaAlphabet>();
+
+    CHECK(ByteAlphabet::size == 256);
+    CHECK(LowercaseAlphabet::size == 26);
+    CHECK(DnaAlphabet::size == 4);
+    CHECK(LowercaseAlphabet::toCode('A') < 0);
+    CHECK(DnaAlphabet::toCode('a') < 0);
+    CHECK(isValidKey<DnaAlphabet>("GATTACA"));
+    CHECK(!isValidKey<DnaAlphabet>("GATTACA!"));
+
+    std::mt19937 rng(26);
+
+    // Lowercase keys with a sprinkling of digits and capitals
+    auto keys = randomKeys(rng, 3000, 'a', 'f', 8);
+    for (size_t i = 0; i < keys.size(); i += 7) {
+        keys[i][rng() % keys[i].size()] = (i % 2) ? '7' : 'Q';
+    }
+    auto probes = randomKeys(rng, 3000, 'a', 'f', 8);
+    probes.insert(probes.end(), keys.begin(), keys.begin() + 500);
+
+    checkTrie<BasicStandardTrie<LowercaseAlphabet>, LowercaseAlphabet>(keys, probes);
+    checkTrie<BasicCompressedTrie<LowercaseAlphabet>, LowercaseAlphabet>(keys, probes);
+    checkTrie<BasicDoubleArrayTrie<LowercaseAlphabet>, LowercaseAlphabet>(keys, probes);
+    checkTrie<StandardTrie, ByteAlphabet>(keys, probes);
+    checkTrie<CompressedTrie, ByteAlphabet>(keys, probes);
+
+    auto dnaKeys = randomKeys(rng, 3000, 'A', 'Z', 10);
+    auto dnaProbes = randomKeys(rng, 3000, 'A', 'Z', 10);
+    for (auto* list : {&dnaKeys, &dnaProbes}) {
+        for (auto& key : *list) {
+            for (char& c : key) {
+                c = (rng() % 20 == 0) ? c : "ACGT"[c % 4];
+            }
+        }
+    }
+    dnaProbes.insert(dnaProbes.end(), dnaKeys.begin(), dnaKeys.begin() + 500);
+
+    checkTrie<BasicStandardTrie<DnaAlphabet>, DnaAlphabet>(dnaKeys, dnaProbes);
+    checkTrie<BasicCompressedTrie<DnaAlphabet>, DnaAlphabet>(dnaKeys, dnaProbes);
+    checkTrie<BasicDoubleArrayTrie<DnaAlphabet>, DnaAlphabet>(dnaKeys, dnaProbes);
+
+    return finish("alphabet");
+}
@@ -0,0 +1,49 @@
+#include "check.h"
+#include "burst_trie.h"
+#include <algorithm>
+
+// Inserts and removes in random order, comparing after every round. The
+// keys share long prefixes, so containers burst at several depths and
+// some keys end exactly where a container starts.
+template<typename TrieType>
+void checkChurn(const std::vector<std::string>& keys, const std::vector<std::string>& probes, std::mt19937& rng) {
+    TrieType trie;
+    Oracle oracle;
+
+    for (int round = 0; round < 4; round++) {
+        for (size_t i = 0; i < keys.size() / 2; i++) {
+            const std::string& key = keys[rng() % keys.size()];
+            trie.insert(key);
+            oracle.insert(key);
+        }
+        for (size_t i = 0; i < keys.size() / 8; i++) {
+            const std::string& key = keys[rng() % keys.size()];
+            CHECK(trie.remove(key) == (oracle.erase(key) > 0));
+        }
+
+        checkLookups(trie, oracle, probes);
+        auto words = trie.getAllWords();
+        std::sort(words.begin(), words.end());
+        CHECK(words == std::vector<std::string>(oracle.begin(), oracle.end()));
+    }
+}
+
+int main() {
+    std::mt19937 rng(37);
+    auto keys = randomKeys(rng, 4000, 'a', 'c', 10);
+    for (size_t i = 0; i < 1000; i++) {
+        keys.push_back("commonprefix" + keys[i]);
+    }
+    keys.push_back("common");
+    keys.push_back("c");
+    keys.push_back("");
+
+    auto probes = randomKeys(rng, 2000, 'a', 'd', 11);
+    probes.insert(probes.end(), keys.begin(), keys.end());
+    probes.push_back("commonp");
+
+    checkChurn<BurstTrie>(keys, probes, rng);
+    checkChurn<BasicBurstTrie<LowercaseAlphabet>>(keys, probes, rng);
+
+    return finish("burst_trie");
+}
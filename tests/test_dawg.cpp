@@ -0,0 +1,79 @@
+#include "check.h"
+#include "dawg.h"
+
+// States of the minimal automaton: one per distinct set of suffixes that
+// complete some prefix of a key to a key
+static size_t minimalStates(const Oracle& oracle) {
+    Oracle prefixes;
+    for (const auto& key : oracle) {
+        for (size_t length = 0; length <= key.size(); length++) {
+            prefixes.insert(key.substr(0, length));
+        }
+    }
+
+    std::set<std::vector<std::string>> futures;
+    for (const auto& prefix : prefixes) {
+        std::vector<std::string> suffixes;
+        for (auto it = oracle.lower_bound(prefix); it != oracle.end() && it->compare(0, prefix.size(), prefix) == 0;
+             ++it) {
+            suffixes.push_back(it->substr(prefix.size()));
+        }
+        futures.insert(suffixes);
+    }
+    return futures.size();
+}
+
+template<typename DawgType>
+void checkDawg(const std::vector<std::string>& keys, const std::vector<std::string>& probes) {
+    Oracle oracle(keys.begin(), keys.end());
+    DawgType dawg;
+    for (const auto& key : oracle) {
+        dawg.insert(key);
+        dawg.insert(key);  // repeats and keys out of order are ignored
+        dawg.insert("");
+    }
+    dawg.build();
+    dawg.insert("zzzz-after-build");
+
+    checkLookups(dawg, oracle, probes);
+    CHECK(dawg.getAllWords() == std::vector<std::string>(oracle.begin(), oracle.end()));
+    CHECK(dawg.getNodeCount() == minimalStates(oracle));
+
+    for (const auto& probe : probes) {
+        size_t longest = 0;
+        for (size_t length = 1; length <= probe.size(); length++) {
+            if (oracle.count(probe.substr(0, length))) {
+                longest = length;
+            }
+        }
+        CHECK(dawg.longestPrefixMatch(probe) == longest);
+    }
+}
+
+int main() {
+    std::mt19937 rng(42);
+
+    // Shared endings, so merging actually happens
+    auto stems = randomKeys(rng, 400, 'a', 'e', 5);
+    std::vector<std::string> keys;
+    for (const auto& stem : stems) {
+        for (const char* ending : {"", "ing", "ed", "s", "tion"}) {
+            if (rng() % 2) {
+                keys.push_back(stem + ending);
+            }
+        }
+    }
+    auto random = randomKeys(rng, 1500, 'a', 'z', 7);
+    keys.insert(keys.end(), random.begin(), random.end());
+
+    auto probes = randomKeys(rng, 2000, 'a', 'z', 8);
+    probes.insert(probes.end(), keys.begin(), keys.end());
+    for (const auto& stem : stems) {
+        probes.push_back(stem + "in");
+    }
+
+    checkDawg<BasicDawg<ByteAlphabet>>(keys, probes);
+    checkDawg<BasicDawg<LowercaseAlphabet>>(keys, probes);
+
+    return finish("dawg");
+}
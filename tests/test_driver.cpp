@@ -0,0 +1,123 @@
+#include "check.h"
+#include "benchmark.h"
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+// Splits one RFC 4180 line into its fields
+static std::vector<std::string> parseCsv(const std::string& line) {
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                fields.back() += '"';
+                i++;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                fields.back() += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.emplace_back();
+        } else {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+// Decodes the JSON string starting at json[pos] (the opening quote)
+static std::string parseJsonString(const std::string& json, size_t pos) {
+    std::string text;
+    for (pos++; pos < json.size() && json[pos] != '"'; pos++) {
+        if (json[pos] != '\\') {
+            text += json[pos];
+        } else if (json[pos + 1] == 'u') {
+            text += static_cast<char>(std::stoi(json.substr(pos + 2, 4), nullptr, 16));
+            pos += 5;
+        } else {
+            text += json[++pos];
+        }
+    }
+    return text;
+}
+
+static std::string jsonField(const std::string& json, const std::string& name) {
+    size_t pos = json.find("\"" + name + "\":");
+    return pos == std::string::npos ? "" : parseJsonString(json, pos + name.size() + 3);
+}
+
+static void checkOutputEscaping() {
+    BenchmarkResult result;
+    result.trieType = "odd \"name\", with\ta tab";
+    result.keySource = "dir\\keys,v2\n.txt";
+    result.calculateAverages();
+
+    auto header = parseCsv(BenchmarkResult::csvHeader());
+    auto row = parseCsv(result.toCsv());
+    CHECK(row.size() == header.size());
+    CHECK(row[0] == result.trieType);
+    CHECK(header[8] == "KeySource" && row[8] == result.keySource);
+
+    std::string json = result.toJson();
+    CHECK(json.find('\n') == std::string::npos);
+    CHECK(jsonField(json, "trieType") == result.trieType);
+    CHECK(jsonField(json, "keySource") == result.keySource);
+}
+
+// Runs every variant on one key file. Each must store exactly the
+// distinct keys, and the workloads whose answers depend only on the key
+// set must find the same number of matches on every variant.
+static void checkVariants() {
+    std::mt19937 rng(27);
+    auto keys = randomKeys(rng, 400, 'a', 'e', 7);
+    Oracle oracle(keys.begin(), keys.end());
+
+    auto path = std::filesystem::temp_directory_path() / "trie_test_driver_keys.txt";
+    {
+        std::ofstream file(path);
+        for (const auto& key : keys) {
+            file << key << "\n";
+        }
+    }
+
+    std::map<std::string, size_t> firstAnswer;
+    auto sameAsOthers = [&firstAnswer](const std::string& workload, size_t matches) {
+        auto inserted = firstAnswer.emplace(workload, matches);
+        return inserted.second || inserted.first->second == matches;
+    };
+
+    for (const auto& variant : Benchmark::variants()) {
+        Benchmark benchmark;
+        benchmark.loadFromFile(path.string());
+        benchmark.setQueryCount(50);
+        benchmark.setWorkloads({"search", "miss", "fuzzy", "pattern", "range", "count"});
+        benchmark.setSeed(1);
+
+        BenchmarkResult result = variant.run(benchmark);
+        CHECK(result.wordCount == oracle.size());
+        CHECK(result.searchCount == 50);
+        if (result.fuzzyCount > 0) {
+            CHECK(sameAsOthers("fuzzy", result.fuzzyMatches));
+        }
+        if (result.patternCount > 0) {
+            CHECK(sameAsOthers("pattern", result.patternMatches));
+        }
+        if (result.rangeCount > 0) {
+            CHECK(sameAsOthers("range", result.rangeKeys));
+        }
+    }
+    std::filesystem::remove(path);
+
+    CHECK(Benchmark::findVariant("compressed") != nullptr);
+}
+
+int main() {
+    checkOutputEscaping();
+    checkVariants();
+    return finish("driver");
+}
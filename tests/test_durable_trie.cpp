@@ -0,0 +1,224 @@
+#include "check.h"
+#include "compressed_trie.h"
+#include "durable_trie.h"
+#include "standard_trie.h"
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+// A log record is a checksum, the key length, the operation and the key
+static const size_t RECORD_HEADER = 9;
+
+// One logged change: only inserts of new keys and removes of present
+// ones reach the log
+struct Change {
+    bool insert;
+    std::string key;
+};
+
+static Oracle replay(const std::vector<Change>& changes, size_t count) {
+    Oracle oracle;
+    for (size_t i = 0; i < count; i++) {
+        if (changes[i].insert) {
+            oracle.insert(changes[i].key);
+        } else {
+            oracle.erase(changes[i].key);
+        }
+    }
+    return oracle;
+}
+
+template<typename TrieType>
+bool holds(const DurableTrie<TrieType>& trie, const Oracle& oracle) {
+    return trie.getWordCount() == oracle.size() && scanRange(trie, "", "") == expectedRange(oracle, "", "");
+}
+
+static void flipByte(const fs::path& path, size_t offset) {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(offset);
+    char byte = static_cast<char>(file.get());
+    file.seekp(offset);
+    file.put(static_cast<char>(byte ^ 0x5a));
+}
+
+// Random changes through small groups and frequent checkpoints, then a
+// clean reopen
+template<typename TrieType>
+void checkReopen(const fs::path& directory, std::mt19937& rng) {
+    fs::remove_all(directory);
+    DurabilityOptions options;
+    options.groupCommitRecords = 7;
+    options.checkpointLogBytes = 2000;
+    options.sync = false;
+
+    auto keys = randomKeys(rng, 800, 'a', 'f', 8);
+    Oracle oracle;
+    {
+        DurableTrie<TrieType> trie;
+        CHECK(trie.open(directory.string(), options));
+        for (size_t i = 0; i < 4000; i++) {
+            const std::string& key = keys[rng() % keys.size()];
+            if (rng() % 3 == 0) {
+                CHECK(trie.remove(key) == (oracle.erase(key) > 0));
+            } else {
+                trie.insert(key);
+                oracle.insert(key);
+            }
+        }
+        CHECK(holds(trie, oracle));
+        CHECK(trie.close());
+    }
+
+    DurableTrie<TrieType> reopened;
+    CHECK(reopened.open(directory.string(), options));
+    CHECK(holds(reopened, oracle));
+    CHECK(reopened.getRecoveryInfo().checkpointKeys > 0);
+    CHECK(reopened.getRecoveryInfo().discardedBytes == 0);
+}
+
+// Writes changes into a log with no checkpoint and returns the log size
+template<typename TrieType>
+size_t writeLog(const fs::path& directory, const std::vector<Change>& changes) {
+    fs::remove_all(directory);
+    DurabilityOptions options;
+    options.checkpointLogBytes = SIZE_MAX;
+    options.sync = false;
+
+    DurableTrie<TrieType> trie;
+    CHECK(trie.open(directory.string(), options));
+    for (const auto& change : changes) {
+        if (change.insert) {
+            trie.insert(change.key);
+        } else {
+            CHECK(trie.remove(change.key));
+        }
+    }
+    CHECK(trie.close());
+    return fs::file_size(directory / "wal");
+}
+
+// A torn or corrupt record is cut off with everything after it; the
+// records before it come back, and the log is trimmed so that new
+// records follow the last good one
+template<typename TrieType>
+void checkDamagedTail(const fs::path& directory, std::mt19937& rng) {
+    auto keys = randomKeys(rng, 300, 'a', 'z', 12);
+    std::vector<Change> changes;
+    Oracle present;
+    for (const auto& key : keys) {
+        if (!present.count(key)) {
+            changes.push_back({true, key});
+            present.insert(key);
+        } else if (rng() % 2) {
+            changes.push_back({false, key});
+            present.erase(key);
+        }
+    }
+    changes.push_back({true, "thelastkey"});
+    const size_t lastRecord = RECORD_HEADER + changes.back().key.size();
+    const fs::path log = directory / "wal";
+
+    DurabilityOptions options;
+    options.sync = false;
+
+    // Torn last record, cut at every possible length
+    for (size_t kept = 0; kept < lastRecord; kept++) {
+        size_t full = writeLog<TrieType>(directory, changes);
+        fs::resize_file(log, full - lastRecord + kept);
+
+        DurableTrie<TrieType> trie;
+        CHECK(trie.open(directory.string(), options));
+        CHECK(holds(trie, replay(changes, changes.size() - 1)));
+        CHECK(trie.getRecoveryInfo().replayedRecords == changes.size() - 1);
+        CHECK(trie.getRecoveryInfo().discardedBytes == kept);
+        CHECK(fs::file_size(log) == full - lastRecord);
+
+        trie.insert("afterrecovery");
+        CHECK(trie.close());
+        DurableTrie<TrieType> again;
+        CHECK(again.open(directory.string(), options));
+        CHECK(again.search("afterrecovery") && !again.search("thelastkey"));
+        CHECK(again.getRecoveryInfo().discardedBytes == 0);
+    }
+
+    // A flipped byte anywhere in the last record: header, operation or key
+    for (size_t offset = 0; offset < lastRecord; offset++) {
+        size_t full = writeLog<TrieType>(directory, changes);
+        flipByte(log, full - lastRecord + offset);
+
+        DurableTrie<TrieType> trie;
+        CHECK(trie.open(directory.string(), options));
+        CHECK(holds(trie, replay(changes, changes.size() - 1)));
+        CHECK(trie.getRecoveryInfo().discardedBytes == lastRecord);
+    }
+
+    // A corrupt record in the middle ends the replay there
+    size_t full = writeLog<TrieType>(directory, changes);
+    size_t middle = changes.size() / 2;
+    size_t offset = 0;
+    for (size_t i = 0; i < middle; i++) {
+        offset += RECORD_HEADER + changes[i].key.size();
+    }
+    flipByte(log, offset + RECORD_HEADER);
+    DurableTrie<TrieType> trie;
+    CHECK(trie.open(directory.string(), options));
+    CHECK(holds(trie, replay(changes, middle)));
+    CHECK(trie.getRecoveryInfo().discardedBytes == full - offset);
+}
+
+// A crash between writing a checkpoint and emptying the log replays the
+// old log over the checkpoint, which must change nothing
+template<typename TrieType>
+void checkStaleLog(const fs::path& directory, std::mt19937& rng) {
+    fs::remove_all(directory);
+    DurabilityOptions options;
+    options.checkpointLogBytes = SIZE_MAX;
+    options.sync = false;
+
+    Oracle oracle;
+    const fs::path saved = directory.string() + "-wal";
+    {
+        DurableTrie<TrieType> trie;
+        CHECK(trie.open(directory.string(), options));
+        for (const auto& key : randomKeys(rng, 2000, 'a', 'e', 7)) {
+            if (rng() % 4 == 0) {
+                trie.remove(key);
+                oracle.erase(key);
+            } else {
+                trie.insert(key);
+                oracle.insert(key);
+            }
+        }
+        CHECK(trie.commit());
+        fs::copy_file(directory / "wal", saved, fs::copy_options::overwrite_existing);
+        CHECK(trie.checkpoint());
+        CHECK(fs::file_size(directory / "wal") == 0);
+    }
+    fs::copy_file(saved, directory / "wal", fs::copy_options::overwrite_existing);
+    fs::remove(saved);
+
+    DurableTrie<TrieType> trie;
+    CHECK(trie.open(directory.string(), options));
+    CHECK(holds(trie, oracle));
+    CHECK(trie.close());
+
+    // A damaged checkpoint is refused rather than half loaded
+    flipByte(directory / "checkpoint", fs::file_size(directory / "checkpoint") / 2);
+    DurableTrie<TrieType> damaged;
+    CHECK(!damaged.open(directory.string(), options));
+}
+
+int main() {
+    std::mt19937 rng(44);
+    const fs::path directory = fs::temp_directory_path() / "trie_test_durable";
+
+    checkReopen<CompressedTrie>(directory, rng);
+    checkReopen<StandardTrie>(directory, rng);
+    checkDamagedTail<CompressedTrie>(directory, rng);
+    checkDamagedTail<BasicCompressedTrie<LowercaseAlphabet>>(directory, rng);
+    checkStaleLog<CompressedTrie>(directory, rng);
+
+    fs::remove_all(directory);
+    return finish("durable_trie");
+}
@@ -0,0 +1,80 @@
+#include "check.h"
+#include "compressed_trie.h"
+#include "double_array_trie.h"
+#include "frozen_trie.h"
+#include "standard_trie.h"
+
+// A frozen copy answers like the source, removed keys included; the
+// empty key is dropped because a double array can't hold it
+template<typename SourceType>
+void checkFreeze(const std::vector<std::string>& keys, const std::vector<std::string>& probes, std::mt19937& rng) {
+    SourceType source;
+    Oracle oracle;
+    for (const auto& key : keys) {
+        source.insert(key);
+        oracle.insert(key);
+    }
+    for (size_t i = 0; i < keys.size() / 4; i++) {
+        const std::string& key = keys[rng() % keys.size()];
+        source.remove(key);
+        oracle.erase(key);
+    }
+    oracle.erase("");
+
+    auto frozen = source.freeze();
+    checkLookups(frozen, oracle, probes);
+    CHECK(scanRange(frozen, "", "") == expectedRange(oracle, "", ""));
+
+    // Inserting the same keys straight into a double array gives the same answers
+    DoubleArrayTrie direct;
+    for (const auto& key : oracle) {
+        direct.insert(key);
+    }
+    CHECK(frozen.getNodeCount() == direct.getNodeCount());
+    CHECK(frozen.getArraySize() <= direct.getArraySize());
+}
+
+// build() more than once keeps every key inserted so far
+template<typename FrozenType>
+void checkRebuild(const std::vector<std::string>& keys, const std::vector<std::string>& probes) {
+    FrozenType trie;
+    Oracle oracle;
+    size_t third = keys.size() / 3;
+    for (size_t batch = 0; batch < 3; batch++) {
+        for (size_t i = batch * third; i < (batch + 1) * third; i++) {
+            trie.insert(keys[i]);
+            oracle.insert(keys[i]);
+        }
+        trie.build();
+        checkLookups(trie, oracle, probes);
+        CHECK(scanRange(trie, "", "") == expectedRange(oracle, "", ""));
+    }
+
+    // keys inserted after the last build() stay invisible until the next
+    trie.insert("zzz-not-built");
+    CHECK(!trie.search("zzz-not-built"));
+    trie.build();
+    CHECK(trie.search("zzz-not-built"));
+
+    trie.clear();
+    CHECK(trie.getWordCount() == 0 && !trie.search(keys[0]));
+}
+
+int main() {
+    std::mt19937 rng(40);
+    auto keys = randomKeys(rng, 6000, 'a', 'e', 9);
+    keys.push_back("");
+    auto probes = randomKeys(rng, 2000, 'a', 'f', 9);
+    probes.insert(probes.end(), keys.begin(), keys.begin() + 2000);
+
+    checkFreeze<StandardTrie>(keys, probes, rng);
+    checkFreeze<CompressedTrie>(keys, probes, rng);
+    checkFreeze<BasicCompressedTrie<LowercaseAlphabet>>(keys, probes, rng);
+
+    keys.pop_back();
+    checkRebuild<FrozenTrie<StandardTrie>>(keys, probes);
+    checkRebuild<FrozenTrie<CompressedTrie>>(keys, probes);
+    checkRebuild<FrozenTrie<CompressedTrie, ToDawg<ByteAlphabet>>>(keys, probes);
+
+    return finish("freeze");
+}
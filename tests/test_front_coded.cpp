@@ -0,0 +1,67 @@
+#include "check.h"
+#include "front_coded_dictionary.h"
+
+static std::vector<std::string> prefixScan(const FrontCodedDictionary& dictionary, const std::string& prefix) {
+    std::vector<std::string> found;
+    dictionary.prefixScan(prefix, [&found](const std::string& key) {
+        found.push_back(key);
+        return true;
+    });
+    return found;
+}
+
+static void checkDictionary(const FrontCodedDictionary& dictionary, const Oracle& oracle,
+                            const std::vector<std::string>& probes) {
+    checkLookups(dictionary, oracle, probes);
+    CHECK(dictionary.getAllWords() == std::vector<std::string>(oracle.begin(), oracle.end()));
+    CHECK(dictionary.getNodeCount() == (oracle.size() + 15) / 16);
+
+    for (size_t i = 0; i + 1 < probes.size(); i += 5) {
+        CHECK(scanRange(dictionary, probes[i], probes[i + 1]) == expectedRange(oracle, probes[i], probes[i + 1]));
+        std::string prefix = probes[i].substr(0, 2);
+        CHECK(prefixScan(dictionary, prefix) == expectedRange(oracle, prefix, prefix + '\xff'));
+    }
+}
+
+int main() {
+    std::mt19937 rng(43);
+    auto keys = randomKeys(rng, 5000, 'a', 'f', 9);
+    auto probes = randomKeys(rng, 3000, 'a', 'g', 9);
+    probes.insert(probes.end(), keys.begin(), keys.begin() + 2000);
+    probes.push_back("");
+
+    FrontCodedDictionary dictionary;
+    Oracle oracle;
+    checkDictionary(dictionary, oracle, probes);  // nothing built yet
+
+    // Keys come in three builds, each merged with the ones before, and
+    // queries see only what the last build() encoded
+    size_t third = keys.size() / 3;
+    for (size_t batch = 0; batch < 3; batch++) {
+        for (size_t i = batch * third; i < (batch + 1) * third; i++) {
+            dictionary.insert(keys[i]);
+        }
+        CHECK(dictionary.getWordCount() == oracle.size());
+        oracle.insert(keys.begin() + batch * third, keys.begin() + (batch + 1) * third);
+        dictionary.build();
+        checkDictionary(dictionary, oracle, probes);
+    }
+
+    // The empty key and a block of exactly BLOCK_SIZE keys
+    FrontCodedDictionary small;
+    Oracle smallOracle = {""};
+    small.insert("");
+    for (int i = 0; i < 15; i++) {
+        std::string key = "k" + std::to_string(i);
+        small.insert(key);
+        smallOracle.insert(key);
+    }
+    small.build();
+    checkDictionary(small, smallOracle, probes);
+    CHECK(small.search("") && small.lowerBound("") == "");
+
+    small.clear();
+    CHECK(small.getWordCount() == 0 && !small.search("k1"));
+
+    return finish("front_coded");
+}
@@ -0,0 +1,94 @@
+#include "check.h"
+#include "compressed_trie.h"
+#include "double_array_trie.h"
+#include "frozen_trie.h"
+#include "standard_trie.h"
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+static int editDistance(const std::string& a, const std::string& b) {
+    std::vector<int> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); j++) {
+        row[j] = static_cast<int>(j);
+    }
+    for (size_t i = 1; i <= a.size(); i++) {
+        int diagonal = row[0];
+        row[0] = static_cast<int>(i);
+        for (size_t j = 1; j <= b.size(); j++) {
+            int above = row[j];
+            row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] != b[j - 1])});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+using Matches = std::vector<std::pair<std::string, int>>;
+
+static Matches expectedMatches(const Oracle& oracle, const std::string& query, int maxDistance) {
+    Matches matches;
+    for (const auto& key : oracle) {
+        int distance = editDistance(key, query);
+        if (distance <= maxDistance) {
+            matches.emplace_back(key, distance);
+        }
+    }
+    return matches;
+}
+
+template<typename TrieType>
+Matches fuzzyMatches(const TrieType& trie, const std::string& query, int maxDistance) {
+    Matches matches;
+    for (const auto& match : trie.fuzzySearch(query, maxDistance)) {
+        matches.emplace_back(match.word, match.distance);
+    }
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+template<typename TrieType>
+void checkTrie(const std::vector<std::string>& keys, const std::vector<std::string>& queries, bool storesEmpty) {
+    TrieType trie;
+    Oracle oracle;
+    for (const auto& key : keys) {
+        trie.insert(key);
+        if (!key.empty() || storesEmpty) {
+            oracle.insert(key);
+        }
+    }
+    if constexpr (std::is_same_v<TrieType, FrozenTrie<CompressedTrie>>) {
+        trie.build();
+    }
+
+    for (const auto& query : queries) {
+        for (int maxDistance = 0; maxDistance <= 2; maxDistance++) {
+            CHECK(fuzzyMatches(trie, query, maxDistance) == expectedMatches(oracle, query, maxDistance));
+        }
+    }
+}
+
+int main() {
+    std::mt19937 rng(28);
+    auto keys = randomKeys(rng, 1500, 'a', 'd', 6);
+    keys.push_back("");
+    keys.push_back("a");
+
+    // Queries near stored keys, unrelated ones, and the empty query
+    auto queries = randomKeys(rng, 60, 'a', 'e', 7);
+    for (size_t i = 0; i < 60; i++) {
+        std::string query = keys[rng() % keys.size()];
+        if (!query.empty()) {
+            query[rng() % query.size()] = 'e';
+        }
+        queries.push_back(query);
+    }
+    queries.push_back("");
+
+    checkTrie<StandardTrie>(keys, queries, true);
+    checkTrie<CompressedTrie>(keys, queries, false);
+    checkTrie<DoubleArrayTrie>(keys, queries, false);
+    checkTrie<FrozenTrie<CompressedTrie>>(keys, queries, false);
+
+    return finish("fuzzy");
+}
@@ -0,0 +1,61 @@
+#include "check.h"
+#include "hat_trie.h"
+#include <algorithm>
+
+static std::vector<std::string> expectedPrefix(const Oracle& oracle, const std::string& prefix) {
+    std::vector<std::string> keys;
+    for (auto it = oracle.lower_bound(prefix); it != oracle.end() && it->compare(0, prefix.size(), prefix) == 0; ++it) {
+        keys.push_back(*it);
+    }
+    return keys;
+}
+
+// Enough keys under one prefix that the root container grows its slot
+// array several times and then bursts, with removes in between
+template<typename TrieType>
+void checkChurn(const std::vector<std::string>& keys, const std::vector<std::string>& probes, std::mt19937& rng) {
+    TrieType trie;
+    Oracle oracle;
+
+    for (int round = 0; round < 3; round++) {
+        for (size_t i = 0; i < keys.size() / 2; i++) {
+            const std::string& key = keys[rng() % keys.size()];
+            trie.insert(key);
+            oracle.insert(key);
+        }
+        for (size_t i = 0; i < keys.size() / 8; i++) {
+            const std::string& key = keys[rng() % keys.size()];
+            CHECK(trie.remove(key) == (oracle.erase(key) > 0));
+        }
+
+        checkLookups(trie, oracle, probes);
+        auto words = trie.getAllWords();
+        std::sort(words.begin(), words.end());
+        CHECK(words == std::vector<std::string>(oracle.begin(), oracle.end()));
+
+        for (size_t i = 0; i < 200; i++) {
+            std::string prefix = probes[i].substr(0, 1 + i % 3);
+            std::vector<std::string> found;
+            trie.prefixScan(prefix, [&found](const std::string& key) {
+                found.push_back(key);
+                return true;
+            });
+            CHECK(found == expectedPrefix(oracle, prefix));
+        }
+    }
+}
+
+int main() {
+    std::mt19937 rng(38);
+    auto keys = randomKeys(rng, 30000, 'a', 'd', 12);
+    keys.push_back("a");
+    keys.push_back("");
+
+    auto probes = randomKeys(rng, 3000, 'a', 'e', 12);
+    probes.insert(probes.end(), keys.begin(), keys.begin() + 3000);
+
+    checkChurn<HatTrie>(keys, probes, rng);
+    checkChurn<BasicHatTrie<LowercaseAlphabet>>(keys, probes, rng);
+
+    return finish("hat_trie");
+}
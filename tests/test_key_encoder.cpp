@@ -0,0 +1,94 @@
+#include "check.h"
+#include "compressed_trie.h"
+#include "double_array_trie.h"
+#include "encoded_trie.h"
+#include "key_encoder.h"
+#include "standard_trie.h"
+
+// URL-like keys, so training finds long shared n-grams, plus bytes the
+// sample never had
+static std::vector<std::string> makeKeys(std::mt19937& rng, size_t count) {
+    static const char* hosts[] = {"http://www.example.com/", "https://api.example.org/v2/", "http://test.net/"};
+    auto tails = randomKeys(rng, count, 'a', 'h', 10);
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < count; i++) {
+        keys.push_back(hosts[rng() % 3] + tails[i]);
+    }
+    return keys;
+}
+
+static int sign(int value) { return (value > 0) - (value < 0); }
+
+static void checkEncoder(const std::vector<std::string>& sample, const std::vector<std::string>& keys) {
+    KeyEncoder encoder;
+    CHECK(encoder.encode("abc") == "abc");  // untrained encoders pass keys through
+    encoder.train(sample, 512, 6);
+    CHECK(encoder.isTrained());
+
+    std::vector<std::string> codes;
+    for (const auto& key : keys) {
+        codes.push_back(encoder.encode(key));
+        CHECK(encoder.decode(codes.back()) == key);
+    }
+
+    // Order (and equality) survive for every pair of neighbours and for
+    // pairs across the whole set
+    for (size_t i = 0; i + 1 < keys.size(); i++) {
+        size_t j = (i * 7919) % keys.size();
+        CHECK(sign(keys[i].compare(keys[i + 1])) == sign(codes[i].compare(codes[i + 1])));
+        CHECK(sign(keys[i].compare(keys[j])) == sign(codes[i].compare(codes[j])));
+    }
+
+    // Sorting by code gives the keys in order
+    Oracle sorted(keys.begin(), keys.end());
+    std::set<std::string> byCode(codes.begin(), codes.end());
+    std::vector<std::string> decoded;
+    for (const auto& code : byCode) {
+        decoded.push_back(encoder.decode(code));
+    }
+    CHECK(decoded == std::vector<std::string>(sorted.begin(), sorted.end()));
+}
+
+template<typename TrieType>
+void checkEncodedTrie(const std::vector<std::string>& sample, const std::vector<std::string>& keys,
+                      const std::vector<std::string>& probes) {
+    EncodedTrie<TrieType> trie;
+    trie.train(sample);
+    Oracle oracle;
+    for (const auto& key : keys) {
+        trie.insert(key);
+        oracle.insert(key);
+    }
+
+    checkLookups(trie, oracle, probes);
+    CHECK(scanRange(trie, "", "") == expectedRange(oracle, "", ""));
+    CHECK(scanRange(trie, "http://test.net/c", "https://") == expectedRange(oracle, "http://test.net/c", "https://"));
+}
+
+int main() {
+    std::mt19937 rng(36);
+    auto sample = makeKeys(rng, 2000);
+    auto keys = makeKeys(rng, 5000);
+    for (size_t i = 0; i < keys.size(); i += 50) {
+        keys[i] += static_cast<char>(0xF0 + i % 16);
+        keys[i + 1] = keys[i].substr(0, keys[i].size() / 2);
+    }
+    keys.push_back("");
+    keys.push_back(std::string("\0\x01", 2));
+
+    checkEncoder(sample, keys);
+
+    keys.pop_back();
+    keys.pop_back();
+    std::vector<std::string> probes = makeKeys(rng, 2000);
+    probes.insert(probes.end(), keys.begin(), keys.begin() + 1000);
+    for (size_t i = 0; i < 200; i++) {
+        probes.push_back(keys[i].substr(0, rng() % (keys[i].size() + 1)));
+    }
+
+    checkEncodedTrie<StandardTrie>(sample, keys, probes);
+    checkEncodedTrie<CompressedTrie>(sample, keys, probes);
+    checkEncodedTrie<DoubleArrayTrie>(sample, keys, probes);
+
+    return finish("key_encoder");
+}
@@ -0,0 +1,65 @@
+#include "check.h"
+#include "compressed_trie.h"
+#include "standard_trie.h"
+#include <iterator>
+
+template<typename TrieType>
+void checkCounts(const TrieType& trie, const Oracle& oracle, const std::vector<std::string>& probes) {
+    for (const auto& probe : probes) {
+        for (size_t length = 0; length <= probe.size(); length++) {
+            std::string prefix = probe.substr(0, length);
+            // the keys are all below '\xff'
+            CHECK(trie.countPrefix(prefix) == expectedRange(oracle, prefix, prefix + '\xff').size());
+        }
+        CHECK(trie.rank(probe) == static_cast<size_t>(std::distance(oracle.begin(), oracle.lower_bound(probe))));
+    }
+
+    size_t index = 0;
+    for (const auto& key : oracle) {
+        CHECK(trie.select(index) == key);
+        CHECK(trie.rank(key) == index);
+        index++;
+    }
+    CHECK(trie.select(oracle.size()).empty());
+    CHECK(trie.countPrefix("") == oracle.size());
+}
+
+// Removes leave emptied nodes in place, so the counts have to come from
+// wordsBelow rather than from the shape of the trie
+template<typename TrieType>
+void checkTrie(const std::vector<std::string>& keys, const std::vector<std::string>& probes, std::mt19937& rng) {
+    TrieType trie;
+    Oracle oracle;
+    for (const auto& key : keys) {
+        trie.insert(key);
+        oracle.insert(key);
+    }
+    checkCounts(trie, oracle, probes);
+
+    for (size_t i = 0; i < keys.size() / 3; i++) {
+        const std::string& key = keys[rng() % keys.size()];
+        trie.remove(key);
+        oracle.erase(key);
+    }
+    checkCounts(trie, oracle, probes);
+
+    for (size_t i = 0; i < keys.size() / 6; i++) {
+        trie.insert(keys[i]);
+        oracle.insert(keys[i]);
+    }
+    checkCounts(trie, oracle, probes);
+}
+
+int main() {
+    std::mt19937 rng(39);
+    auto keys = randomKeys(rng, 3000, 'a', 'd', 8);
+    auto probes = randomKeys(rng, 300, 'a', 'e', 8);
+    probes.insert(probes.end(), keys.begin(), keys.begin() + 300);
+
+    checkTrie<StandardTrie>(keys, probes, rng);
+    checkTrie<CompressedTrie>(keys, probes, rng);
+    checkTrie<BasicStandardTrie<LowercaseAlphabet>>(keys, probes, rng);
+    checkTrie<BasicCompressedTrie<LowercaseAlphabet>>(keys, probes, rng);
+
+    return finish("order_statistics");
+}
@@ -0,0 +1,96 @@
+#include "check.h"
+#include "compressed_trie.h"
+#include "double_array_trie.h"
+#include "huge_page_allocator.h"
+#include <stdexcept>
+
+static bool samePolicy(const PagePolicy& a, const PagePolicy& b) {
+    return a.hugePages == b.hugePages && a.populate == b.populate;
+}
+
+static void checkScopedPolicy() {
+    PagePolicy before = PagePolicy::current();
+    PagePolicy changed;
+    changed.hugePages = !before.hugePages;
+    changed.populate = !before.populate;
+
+    {
+        ScopedPagePolicy guard(changed);
+        CHECK(samePolicy(PagePolicy::current(), changed));
+    }
+    CHECK(samePolicy(PagePolicy::current(), before));
+
+    try {
+        ScopedPagePolicy guard(changed);
+        throw std::runtime_error("build failed");
+    } catch (const std::runtime_error&) {
+    }
+    CHECK(samePolicy(PagePolicy::current(), before));
+}
+
+// Blocks on both sides of the huge page threshold hold what was written,
+// and the large ones are aligned to a huge page
+static void checkAllocator(const PagePolicy& policy) {
+    ScopedPagePolicy guard(policy);
+    using Array = std::vector<uint32_t, HugePageAllocator<uint32_t>>;
+
+    for (size_t count : {size_t(100), size_t(1) << 19, (size_t(3) << 20) + 7}) {
+        Array values(count);
+        for (size_t i = 0; i < count; i++) {
+            values[i] = static_cast<uint32_t>(i * 2654435761u);
+        }
+        bool intact = true;
+        for (size_t i = 0; i < count; i++) {
+            intact = intact && values[i] == static_cast<uint32_t>(i * 2654435761u);
+        }
+        CHECK(intact);
+#ifdef __linux__
+        if (count * sizeof(uint32_t) >= HugePageAllocator<uint32_t>::HUGE_PAGE_SIZE) {
+            CHECK(reinterpret_cast<uintptr_t>(values.data()) % HugePageAllocator<uint32_t>::HUGE_PAGE_SIZE == 0);
+        }
+#endif
+        values.resize(count * 2 + 1, 7);  // moves into a new block
+        CHECK(values.back() == 7 && values[count / 2] == static_cast<uint32_t>((count / 2) * 2654435761u));
+    }
+}
+
+// A double array large enough for mmap-backed arrays answers the same
+// under every policy
+static void checkDoubleArray(const PagePolicy& policy, const CompressedTrie& source, const Oracle& oracle,
+                             const std::vector<std::string>& probes) {
+    ScopedPagePolicy guard(policy);
+    DoubleArrayTrie frozen = source.freeze();
+    CHECK(frozen.getArraySize() * sizeof(int) >= HugePageAllocator<int>::HUGE_PAGE_SIZE);
+    checkLookups(frozen, oracle, probes);
+}
+
+int main() {
+    checkScopedPolicy();
+
+    PagePolicy plain;
+    plain.hugePages = false;
+    PagePolicy huge;
+    PagePolicy prefault;
+    prefault.populate = true;
+
+    for (const auto& policy : {plain, huge, prefault}) {
+        checkAllocator(policy);
+    }
+
+    std::mt19937 rng(33);
+    auto keys = randomKeys(rng, 200000, 'a', 'z', 16);
+    auto probes = randomKeys(rng, 5000, 'a', 'z', 16);
+    probes.insert(probes.end(), keys.begin(), keys.begin() + 5000);
+
+    CompressedTrie source;
+    for (const auto& key : keys) {
+        source.insert(key);
+    }
+    Oracle oracle(keys.begin(), keys.end());
+
+    for (const auto& policy : {plain, huge, prefault}) {
+        checkDoubleArray(policy, source, oracle, probes);
+    }
+
+    return finish("page_policy");
+}
@@ -0,0 +1,112 @@
+#include "check.h"
+#include "compressed_trie.h"
+#include "double_array_trie.h"
+#include "frozen_trie.h"
+#include "standard_trie.h"
+#include <algorithm>
+#include <type_traits>
+
+// Reference matcher for the glob syntax in glob_pattern.h, by plain
+// backtracking over the key
+static bool globMatches(const std::string& pattern, size_t p, const std::string& key, size_t k) {
+    if (p == pattern.size()) {
+        return k == key.size();
+    }
+    char token = pattern[p];
+    if (token == '*') {
+        for (size_t skip = k; skip <= key.size(); skip++) {
+            if (globMatches(pattern, p + 1, key, skip)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    if (k == key.size()) {
+        return false;
+    }
+    unsigned char c = static_cast<unsigned char>(key[k]);
+    if (token == '?') {
+        return globMatches(pattern, p + 1, key, k + 1);
+    }
+    if (token == '\\') {
+        return key[k] == pattern[p + 1] && globMatches(pattern, p + 2, key, k + 1);
+    }
+    if (token == '[') {
+        size_t i = p + 1;
+        bool negated = pattern[i] == '^' || pattern[i] == '!';
+        if (negated) {
+            i++;
+        }
+        bool member = false;
+        for (bool first = true; first || pattern[i] != ']'; first = false) {
+            unsigned char low = static_cast<unsigned char>(pattern[i]);
+            unsigned char high = low;
+            if (pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+                high = static_cast<unsigned char>(pattern[i + 2]);
+                i += 2;
+            }
+            member = member || (c >= low && c <= high);
+            i++;
+        }
+        return member != negated && globMatches(pattern, i + 1, key, k + 1);
+    }
+    return key[k] == token && globMatches(pattern, p + 1, key, k + 1);
+}
+
+static std::vector<std::string> expectedMatches(const Oracle& oracle, const std::string& pattern) {
+    std::vector<std::string> matches;
+    for (const auto& key : oracle) {
+        if (globMatches(pattern, 0, key, 0)) {
+            matches.push_back(key);
+        }
+    }
+    return matches;
+}
+
+template<typename TrieType>
+void checkTrie(const std::vector<std::string>& keys, const std::vector<std::string>& patterns) {
+    TrieType trie;
+    Oracle oracle;
+    for (const auto& key : keys) {
+        trie.insert(key);
+        oracle.insert(key);
+    }
+    if constexpr (std::is_same_v<TrieType, FrozenTrie<StandardTrie>>) {
+        trie.build();
+    }
+
+    for (const auto& pattern : patterns) {
+        auto matches = trie.matchPattern(pattern);
+        std::sort(matches.begin(), matches.end());
+        CHECK(matches == expectedMatches(oracle, pattern));
+    }
+}
+
+// Random patterns over the key characters and every kind of token
+static std::vector<std::string> randomPatterns(std::mt19937& rng, size_t count) {
+    static const char* tokens[] = {"a", "b", "c", "d", "?", "*", "[ab]", "[^a]", "[!cd]", "[b-d]", "\\c", "\\*"};
+    std::vector<std::string> patterns = {"*", "", "?", "**", "a*", "*d", "[a-d]*[a-d]"};
+    for (size_t i = 0; i < count; i++) {
+        std::string pattern;
+        size_t length = 1 + rng() % 5;
+        for (size_t j = 0; j < length; j++) {
+            pattern += tokens[rng() % (sizeof(tokens) / sizeof(tokens[0]))];
+        }
+        patterns.push_back(pattern);
+    }
+    return patterns;
+}
+
+int main() {
+    std::mt19937 rng(29);
+    auto keys = randomKeys(rng, 2000, 'a', 'd', 6);
+    keys.push_back("a*c");  // literal star for the escape
+    auto patterns = randomPatterns(rng, 300);
+
+    checkTrie<StandardTrie>(keys, patterns);
+    checkTrie<CompressedTrie>(keys, patterns);
+    checkTrie<DoubleArrayTrie>(keys, patterns);
+    checkTrie<FrozenTrie<StandardTrie>>(keys, patterns);
+
+    return finish("pattern");
+}
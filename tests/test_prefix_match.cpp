@@ -0,0 +1,77 @@
+#include "check.h"
+#include "compressed_trie.h"
+#include "dawg.h"
+#include "double_array_trie.h"
+#include "flat_trie.h"
+#include "frozen_trie.h"
+#include "standard_trie.h"
+
+// Lengths of the keys that are prefixes of input, shortest first
+static std::vector<size_t> expectedLengths(const Oracle& oracle, const std::string& input) {
+    std::vector<size_t> lengths;
+    for (size_t length = 0; length <= input.size(); length++) {
+        if (oracle.count(input.substr(0, length))) {
+            lengths.push_back(length);
+        }
+    }
+    return lengths;
+}
+
+template<typename TrieType>
+void checkLongest(const TrieType& trie, const Oracle& oracle, const std::vector<std::string>& inputs) {
+    for (const auto& input : inputs) {
+        auto lengths = expectedLengths(oracle, input);
+        CHECK(trie.longestPrefixMatch(input) == (lengths.empty() ? 0 : lengths.back()));
+    }
+}
+
+template<typename TrieType>
+void checkAll(const TrieType& trie, const Oracle& oracle, const std::vector<std::string>& inputs) {
+    checkLongest(trie, oracle, inputs);
+    for (const auto& input : inputs) {
+        std::vector<size_t> lengths;
+        trie.commonPrefixSearch(input, [&lengths](size_t length) { lengths.push_back(length); });
+        CHECK(lengths == expectedLengths(oracle, input));
+    }
+}
+
+int main() {
+    std::mt19937 rng(31);
+    auto keys = randomKeys(rng, 2000, 'a', 'c', 6);
+    auto inputs = randomKeys(rng, 1000, 'a', 'd', 12);
+    inputs.push_back("");
+
+    Oracle oracle(keys.begin(), keys.end());
+    Oracle withEmpty = oracle;
+    withEmpty.insert("");
+
+    StandardTrie standard;
+    CompressedTrie compressed;
+    DoubleArrayTrie doubleArray;
+    BasicDawg<ByteAlphabet> dawg;
+    FrozenTrie<CompressedTrie> frozen;
+    for (const auto& key : keys) {
+        standard.insert(key);
+        compressed.insert(key);
+        doubleArray.insert(key);
+        frozen.insert(key);
+    }
+    for (const auto& key : oracle) {
+        dawg.insert(key);
+    }
+    dawg.build();
+    frozen.build();
+
+    checkAll(compressed, oracle, inputs);
+    checkAll(doubleArray, oracle, inputs);
+    checkAll(frozen, oracle, inputs);
+    checkLongest(compressed.relayout(), oracle, inputs);
+    checkLongest(dawg, oracle, inputs);
+
+    // The standard trie also stores the empty key, a prefix of everything
+    standard.insert("");
+    checkAll(standard, withEmpty, inputs);
+    checkLongest(standard.relayout(), withEmpty, inputs);
+
+    return finish("prefix_match");
+}
@@ -0,0 +1,101 @@
+#include "check.h"
+#include "burst_trie.h"
+#include "compressed_trie.h"
+#include "dawg.h"
+#include "double_array_trie.h"
+#include "encoded_trie.h"
+#include "flat_trie.h"
+#include "front_coded_dictionary.h"
+#include "frozen_trie.h"
+#include "hat_trie.h"
+#include "standard_trie.h"
+
+// Bounds over a wider range than the keys, including characters the
+// lowercase alphabet doesn't have, so scans have to seek past them
+static std::vector<std::string> randomBounds(std::mt19937& rng, size_t count) {
+    auto bounds = randomKeys(rng, count, '`', 'f', 5);
+    for (size_t i = 0; i < bounds.size(); i += 5) {
+        bounds[i][rng() % bounds[i].size()] = (i % 2) ? 'A' : '~';
+    }
+    bounds.push_back("");
+    return bounds;
+}
+
+template<typename OrderedType>
+void checkRanges(const OrderedType& keys, const Oracle& oracle, const std::vector<std::string>& bounds) {
+    CHECK(scanRange(keys, "", "") == expectedRange(oracle, "", ""));
+
+    for (size_t i = 0; i + 1 < bounds.size(); i++) {
+        const std::string& lo = bounds[i];
+        const std::string& hi = bounds[i + 1];
+        CHECK(scanRange(keys, lo, hi) == expectedRange(oracle, lo, hi));
+        CHECK(scanRange(keys, lo, "") == expectedRange(oracle, lo, ""));
+
+        auto next = oracle.lower_bound(lo);
+        CHECK(keys.lowerBound(lo) == (next == oracle.end() ? "" : *next));
+
+        // A scan stops as soon as the callback says so
+        std::vector<std::string> page;
+        keys.rangeScan(lo, "", [&page](const std::string& key) {
+            page.push_back(key);
+            return page.size() < 3;
+        });
+        auto all = expectedRange(oracle, lo, "");
+        all.resize(std::min<size_t>(all.size(), 3));
+        CHECK(page == all);
+    }
+}
+
+template<typename TrieType>
+void checkTrie(const std::vector<std::string>& keys, const Oracle& oracle, const std::vector<std::string>& bounds) {
+    TrieType trie;
+    for (const auto& key : keys) {
+        trie.insert(key);
+    }
+    checkRanges(trie, oracle, bounds);
+}
+
+int main() {
+    std::mt19937 rng(32);
+    auto keys = randomKeys(rng, 6000, 'a', 'e', 8);
+    Oracle oracle(keys.begin(), keys.end());
+    auto bounds = randomBounds(rng, 400);
+
+    checkTrie<StandardTrie>(keys, oracle, bounds);
+    checkTrie<CompressedTrie>(keys, oracle, bounds);
+    checkTrie<DoubleArrayTrie>(keys, oracle, bounds);
+    checkTrie<BurstTrie>(keys, oracle, bounds);
+    checkTrie<HatTrie>(keys, oracle, bounds);
+    checkTrie<BasicStandardTrie<LowercaseAlphabet>>(keys, oracle, bounds);
+    checkTrie<BasicCompressedTrie<LowercaseAlphabet>>(keys, oracle, bounds);
+    checkTrie<BasicDoubleArrayTrie<LowercaseAlphabet>>(keys, oracle, bounds);
+    checkTrie<BasicBurstTrie<LowercaseAlphabet>>(keys, oracle, bounds);
+    checkTrie<BasicHatTrie<LowercaseAlphabet>>(keys, oracle, bounds);
+
+    BasicCompressedTrie<LowercaseAlphabet> source;
+    for (const auto& key : keys) {
+        source.insert(key);
+    }
+    checkRanges(source.relayout(), oracle, bounds);
+    checkRanges(source.freeze(), oracle, bounds);
+
+    BasicDawg<LowercaseAlphabet> dawg;
+    FrontCodedDictionary frontCoded;
+    for (const auto& key : oracle) {
+        dawg.insert(key);
+        frontCoded.insert(key);
+    }
+    dawg.build();
+    frontCoded.build();
+    checkRanges(dawg, oracle, bounds);
+    checkRanges(frontCoded, oracle, bounds);
+
+    EncodedTrie<CompressedTrie> encoded;
+    encoded.train(std::vector<std::string>(keys.begin(), keys.begin() + 1000));
+    for (const auto& key : keys) {
+        encoded.insert(key);
+    }
+    checkRanges(encoded, oracle, bounds);
+
+    return finish("range_scan");
+}
@@ -0,0 +1,68 @@
+#include "check.h"
+#include "compressed_trie.h"
+#include "flat_trie.h"
+#include "frozen_trie.h"
+#include "standard_trie.h"
+
+// Enough keys that the layout runs past its breadth-first top part, and
+// a wide character range so some nodes have more children than the
+// linear search covers
+template<typename SourceType>
+void checkRelayout(const std::vector<std::string>& keys, const std::vector<std::string>& probes, std::mt19937& rng) {
+    SourceType source;
+    Oracle oracle;
+    for (const auto& key : keys) {
+        source.insert(key);
+        oracle.insert(key);
+    }
+    for (size_t i = 0; i < keys.size() / 4; i++) {
+        const std::string& key = keys[rng() % keys.size()];
+        source.remove(key);
+        oracle.erase(key);
+    }
+
+    auto flat = source.relayout();
+    CHECK(flat.getMemoryUsage() > 256 * 1024);
+    checkLookups(flat, oracle, probes);
+    CHECK(flat.getAllWords() == std::vector<std::string>(oracle.begin(), oracle.end()));
+    CHECK(scanRange(flat, "", "") == expectedRange(oracle, "", ""));
+
+    for (const auto& probe : probes) {
+        size_t longest = 0;
+        for (size_t length = 1; length <= probe.size(); length++) {
+            if (oracle.count(probe.substr(0, length))) {
+                longest = length;
+            }
+        }
+        CHECK(flat.longestPrefixMatch(probe) == longest);
+    }
+}
+
+int main() {
+    std::mt19937 rng(41);
+    auto keys = randomKeys(rng, 60000, 'A', 'z', 10);
+    auto narrow = randomKeys(rng, 20000, 'a', 'c', 14);
+    keys.insert(keys.end(), narrow.begin(), narrow.end());
+
+    auto probes = randomKeys(rng, 3000, 'A', 'z', 10);
+    probes.insert(probes.end(), keys.begin(), keys.begin() + 3000);
+    probes.insert(probes.end(), narrow.begin(), narrow.begin() + 3000);
+
+    checkRelayout<StandardTrie>(keys, probes, rng);
+    checkRelayout<CompressedTrie>(keys, probes, rng);
+
+    // Lowercase keys only for the lowercase tries
+    auto lowercase = randomKeys(rng, 60000, 'a', 'z', 10);
+    checkRelayout<BasicStandardTrie<LowercaseAlphabet>>(lowercase, probes, rng);
+    checkRelayout<BasicCompressedTrie<LowercaseAlphabet>>(lowercase, probes, rng);
+
+    FrozenTrie<CompressedTrie, ToFlatLayout> frozen;
+    Oracle oracle(keys.begin(), keys.end());
+    for (const auto& key : keys) {
+        frozen.insert(key);
+    }
+    frozen.build();
+    checkLookups(frozen, oracle, probes);
+
+    return finish("relayout");
+}
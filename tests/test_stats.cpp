@@ -0,0 +1,165 @@
+#include "check.h"
+#include "burst_trie.h"
+#include "compressed_trie.h"
+#include "double_array_trie.h"
+#include "hat_trie.h"
+#include "standard_trie.h"
+#include <iterator>
+#include <type_traits>
+
+// Every trie node is a distinct prefix of some key, the root included
+static size_t standardNodes(const Oracle& oracle) {
+    Oracle prefixes;
+    for (const auto& key : oracle) {
+        for (size_t length = 0; length <= key.size(); length++) {
+            prefixes.insert(key.substr(0, length));
+        }
+    }
+    return prefixes.size();
+}
+
+// A compressed trie keeps the root plus every prefix that is a key or
+// where the keys branch
+static size_t compressedNodes(const Oracle& oracle) {
+    Oracle branches;
+    for (auto it = oracle.begin(); it != oracle.end(); ++it) {
+        auto next = std::next(it);
+        if (next == oracle.end()) {
+            continue;
+        }
+        size_t common = 0;
+        while (common < it->size() && common < next->size() && (*it)[common] == (*next)[common]) {
+            common++;
+        }
+        if (common < it->size()) {
+            branches.insert(it->substr(0, common));
+        }
+    }
+    branches.insert("");
+    branches.insert(oracle.begin(), oracle.end());
+    return branches.size();
+}
+
+// The snapshot agrees with the getters, and the word count with the set
+template<typename TrieType>
+void checkSnapshot(const TrieType& trie, const Oracle& oracle) {
+    TrieStats stats = trie.stats();
+    CHECK(stats.memoryBytes == trie.getMemoryUsage());
+    CHECK(stats.nodes == trie.getNodeCount());
+    CHECK(stats.words == trie.getWordCount());
+    CHECK(trie.getWordCount() == oracle.size());
+}
+
+template<typename TrieType>
+void checkAccounting(const std::vector<std::string>& keys, std::mt19937& rng) {
+    TrieType trie;
+    const size_t emptyMemory = trie.getMemoryUsage();
+    const size_t emptyNodes = trie.getNodeCount();
+    Oracle oracle;
+
+    size_t memory = emptyMemory;
+    for (const auto& key : keys) {
+        trie.insert(key);
+        oracle.insert(key);
+        CHECK(trie.getMemoryUsage() >= memory);
+        memory = trie.getMemoryUsage();
+    }
+    checkSnapshot(trie, oracle);
+
+    if constexpr (std::is_same_v<TrieType, StandardTrie>) {
+        CHECK(trie.getNodeCount() == standardNodes(oracle));
+    }
+    if constexpr (std::is_same_v<TrieType, CompressedTrie>) {
+        CHECK(trie.getNodeCount() == compressedNodes(oracle));
+    }
+
+    // Repeated keys change nothing
+    for (size_t i = 0; i < keys.size(); i += 3) {
+        trie.insert(keys[i]);
+    }
+    CHECK(trie.getMemoryUsage() == memory);
+    checkSnapshot(trie, oracle);
+
+    for (size_t i = 0; i < keys.size(); i += 2) {
+        const std::string& key = keys[rng() % keys.size()];
+        CHECK(trie.remove(key) == (oracle.erase(key) > 0));
+    }
+    checkSnapshot(trie, oracle);
+
+    trie.clear();
+    CHECK(trie.getMemoryUsage() == emptyMemory);
+    CHECK(trie.getNodeCount() == emptyNodes);
+    CHECK(trie.getWordCount() == 0);
+}
+
+// Exact lookup counts; the per-trie event counters only move when the
+// build has them (make STATS=1)
+template<typename TrieType>
+void checkCounters(const std::vector<std::string>& keys, const std::vector<std::string>& probes) {
+    TrieType trie;
+    Oracle oracle;
+    for (const auto& key : keys) {
+        trie.insert(key);
+        oracle.insert(key);
+    }
+
+    size_t expectedVisited = 0;
+    for (const auto& probe : probes) {
+        trie.search(probe);
+        trie.startsWith(probe);
+        size_t depth = 0;
+        while (depth < probe.size() && oracleHasPrefix(oracle, probe.substr(0, depth + 1))) {
+            depth++;
+        }
+        expectedVisited += 2 * depth;
+    }
+
+    TrieStats stats = trie.stats();
+#if TRIE_STATS
+    CHECK(stats.lookups == 2 * probes.size());
+    if constexpr (std::is_same_v<TrieType, StandardTrie>) {
+        CHECK(stats.nodesVisited == expectedVisited);
+    }
+    if constexpr (std::is_same_v<TrieType, CompressedTrie>) {
+        CHECK(stats.splits > 0);
+    }
+    if constexpr (std::is_same_v<TrieType, DoubleArrayTrie>) {
+        CHECK(stats.relocations > 0 && stats.findBaseCalls > 0);
+    }
+    if constexpr (std::is_same_v<TrieType, BurstTrie>) {
+        CHECK(stats.bursts > 0);
+    }
+
+    // remove() is not a lookup
+    if constexpr (!std::is_same_v<TrieType, DoubleArrayTrie>) {
+        for (const auto& key : keys) {
+            trie.remove(key);
+        }
+        CHECK(trie.stats().lookups == stats.lookups);
+        CHECK(trie.stats().nodesVisited == stats.nodesVisited);
+    }
+#else
+    (void)expectedVisited;
+    CHECK(stats.lookups == 0 && stats.nodesVisited == 0 && stats.splits == 0);
+    CHECK(stats.relocations == 0 && stats.findBaseCalls == 0 && stats.bursts == 0);
+#endif
+}
+
+int main() {
+    std::mt19937 rng(34);
+    auto keys = randomKeys(rng, 5000, 'a', 'f', 9);
+    auto probes = randomKeys(rng, 2000, 'a', 'g', 9);
+
+    checkAccounting<StandardTrie>(keys, rng);
+    checkAccounting<CompressedTrie>(keys, rng);
+    checkAccounting<BurstTrie>(keys, rng);
+    checkAccounting<HatTrie>(keys, rng);
+
+    checkCounters<StandardTrie>(keys, probes);
+    checkCounters<CompressedTrie>(keys, probes);
+    checkCounters<DoubleArrayTrie>(keys, probes);
+    checkCounters<BurstTrie>(keys, probes);
+    checkCounters<HatTrie>(keys, probes);
+
+    return finish("stats");
+}